@@ -0,0 +1,36 @@
+/*
+ * @file	Compression.h
+ * @date	2026-10-19
+ * @brief	Fast block compression, LZ4 block format.
+ */
+
+#ifndef COMPRESSION_H_
+#define COMPRESSION_H_
+
+#include <string>
+#include <cstddef>
+
+namespace Util
+{
+
+/**
+ * Compress a block of data in the LZ4 block format, with a greedy
+ * single-probe match finder. Fast on both sides, a lot less dense than
+ * zlib, which is the point for data decompressed on every access.
+ * see https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+ * @param outCompressed replaced by the compressed bytes
+ */
+void lz4Compress(const char * data, size_t size, std::string& outCompressed);
+
+/**
+ * Decompress a block written by lz4Compress (or any LZ4 block).
+ * The size of the decompressed data must be known, it isn't stored.
+ * @param out must have room for outSize bytes
+ * @return false if the block is corrupted or doesn't fill outSize exactly
+ */
+bool lz4Decompress(const char * compressed, size_t compressedSize, char * out,
+		size_t outSize);
+
+}
+
+#endif /* COMPRESSION_H_ */
@@ -5,7 +5,11 @@
  * @brief	
  */
 
+#ifndef FILEHELPER_H_
+#define FILEHELPER_H_
+
 #include <string>
+#include <cstddef>
 
 namespace Util
 {
@@ -18,5 +22,21 @@ bool fileExist(const std::string& filename);
 
 bool readFile(const std::string& filename, std::string& outContent);
 
+/**
+ * Write the data to a temporary file next to filename, then rename it,
+ * so readers never see a partially written file. The temporary name is
+ * unique, several threads or processes can write the same file, the
+ * last rename wins.
+ */
+bool writeFile(const std::string& filename, const char * data, size_t size);
+
+/**
+ * Create a directory, the parent must exist.
+ * @return true if it was created or already exists
+ */
+bool makeDirectory(const std::string& path);
+
 }
 
+#endif /* FILEHELPER_H_ */
+
@@ -0,0 +1,38 @@
+/*
+ * @file	Hash.h
+ * @date	2026-10-19
+ * @brief	Non-cryptographic hash functions.
+ */
+
+#ifndef HASH_H_
+#define HASH_H_
+
+#include <string>
+#include <cstddef>
+
+namespace Util
+{
+
+/**
+ * 64 bits FNV-1a offset basis, the seed of a new hash.
+ */
+const unsigned long long FNV1A_SEED = 14695981039346656037ULL;
+
+/**
+ * 64 bits FNV-1a hash, fast and good enough to detect changed content.
+ * Pass the result of a previous call as the seed to hash several buffers.
+ * see http://www.isthe.com/chongo/tech/comp/fnv/
+ */
+unsigned long long hashFnv1a(const char * data, size_t size,
+		unsigned long long seed = FNV1A_SEED);
+unsigned long long hashFnv1a(const std::string& str,
+		unsigned long long seed = FNV1A_SEED);
+
+/**
+ * @return the 16 lowercase hexadecimal digits of a hash
+ */
+std::string hashToHex(unsigned long long hash);
+
+}
+
+#endif /* HASH_H_ */
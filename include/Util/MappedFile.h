@@ -0,0 +1,60 @@
+/*
+ * @file	MappedFile.h
+ * @date	2026-10-19
+ * @brief	Read-only memory mapping of a whole file.
+ */
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <string>
+#include <cstddef>
+
+namespace Util
+{
+
+/**
+ * Maps a file in memory with mmap (or CreateFileMapping on Windows) so
+ * it can be read without copying it. The view stays valid until close()
+ * or the destruction of the object. An empty file maps to a NULL view
+ * of size 0.
+ */
+class MappedFile
+{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		/**
+		 * Map a file, closing the previous one if any.
+		 * @param filename
+		 * @return false if the file can't be opened or mapped
+		 */
+		bool open(const std::string& filename);
+		void close();
+
+		/**
+		 * Exchange the mappings, the views stay valid
+		 */
+		void swap(MappedFile& other);
+
+		bool isOpen() const;
+		const char * getData() const;
+		size_t getSize() const;
+
+	private:
+		MappedFile(const MappedFile&);
+		MappedFile& operator=(const MappedFile&);
+
+		const char * mData;
+		size_t mSize;
+		bool mOpen;
+#ifdef _WIN32
+		void * mFileHandle;
+		void * mMappingHandle;
+#endif
+};
+
+} /* namespace Util */
+
+#endif /* MAPPEDFILE_H_ */
@@ -0,0 +1,123 @@
+/*
+ * @file	LuaAllocator.h
+ * @date	2026-10-19
+ * @brief	Size-class arena allocator for Lua states.
+ */
+
+#ifndef LUAALLOCATOR_H_
+#define LUAALLOCATOR_H_
+
+extern "C"
+{
+#include "lua.h"
+}
+
+#include <cstddef>
+#include <vector>
+
+namespace Util
+{
+
+/**
+ * lua_Alloc for a single Lua state. The small blocks, where most of the
+ * tables and strings of a config end up, come from big arena blocks with
+ * a free list per size class, so they almost never reach malloc. The
+ * bigger ones go to malloc as usual.
+ *
+ * Lua gives the size of a block when it frees it, so no header is
+ * stored. The arena never shrinks, a freed small block waits in its free
+ * list for the next allocation of its size class. At close, the small
+ * blocks aren't put back in their free list one by one, the arena blocks
+ * are released in bulk afterwards:
+ *
+ * LuaAllocator allocator;
+ * lua_State * state = allocator.newState();
+ * [...]
+ * allocator.beginClose();
+ * lua_close(state);
+ * allocator.releaseAll();
+ *
+ * Not thread safe, like the state using it.
+ */
+class LuaAllocator
+{
+	public:
+		LuaAllocator();
+
+		/**
+		 * Releases all the arena blocks, no state must use it anymore.
+		 */
+		~LuaAllocator();
+
+		/**
+		 * The lua_Alloc function, userData is the LuaAllocator.
+		 */
+		static void * allocate(void * userData, void * ptr, size_t oldSize,
+				size_t newSize);
+
+		/**
+		 * lua_newstate() with this allocator and the usual panic function.
+		 */
+		lua_State * newState();
+
+		/**
+		 * Stop recycling the small blocks, call it before lua_close().
+		 */
+		void beginClose();
+
+		/**
+		 * Free every arena block at once, after lua_close().
+		 */
+		void releaseAll();
+
+		size_t getUsedSize() const; /**< bytes currently given to Lua */
+		size_t getPeakSize() const; /**< highest getUsedSize() */
+		size_t getReservedSize() const; /**< arena blocks and big blocks */
+		unsigned long getAllocationCount() const;
+		unsigned long getMallocCount() const; /**< the ones that reached malloc */
+
+		/**
+		 * Blocks up to this size are in the arena
+		 */
+		static const size_t MAX_SMALL_SIZE = 512;
+		static const size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+	private:
+		LuaAllocator(const LuaAllocator&);
+		LuaAllocator& operator=(const LuaAllocator&);
+
+		static const size_t SIZE_CLASS_STEP = 16;
+		static const size_t SIZE_CLASS_COUNT = MAX_SMALL_SIZE / SIZE_CLASS_STEP;
+
+		/**
+		 * A freed small block holds the next one of its free list
+		 */
+		struct FreeBlock
+		{
+			FreeBlock * next;
+		};
+
+		static size_t getSizeClass(size_t size);
+
+		void * allocateBlock(size_t size);
+		void freeBlock(void * ptr, size_t size);
+		void * reallocateBlock(void * ptr, size_t oldSize, size_t newSize);
+
+		void * allocateSmall(size_t sizeClass);
+
+		std::vector<char *> mArenaBlocks;
+		char * mCursor; /**< next unused byte of the last arena block */
+		char * mLimit;
+		FreeBlock * mFreeLists[SIZE_CLASS_COUNT];
+		bool mClosing;
+
+		size_t mUsedSize;
+		size_t mPeakSize;
+		size_t mLargeSize; /**< of the blocks given by malloc */
+		unsigned long mAllocationCount;
+		unsigned long mMallocCount;
+};
+
+} /* namespace Util */
+
+#endif /* LUAALLOCATOR_H_ */
@@ -0,0 +1,251 @@
+/*
+ * @file	LuaFunctionRef.h
+ * @date	2026-10-19
+ * @brief	Lua function looked up once, called from C++ many times.
+ */
+
+#ifndef LUAFUNCTIONREF_H_
+#define LUAFUNCTIONREF_H_
+
+#include "LuaResource.h"
+#include "LuaGeometry.h"
+
+#include <cstddef>
+#include <string>
+
+namespace Util
+{
+
+/**
+ * Push an argument of a LuaFunctionRef call. Add overloads, in the
+ * namespace of the type, to pass other types.
+ */
+inline void pushArgument(lua_State * state, int value)
+{
+	lua_pushinteger(state, value);
+}
+
+inline void pushArgument(lua_State * state, unsigned int value)
+{
+	lua_pushinteger(state, static_cast<lua_Integer>(value));
+}
+
+inline void pushArgument(lua_State * state, float value)
+{
+	lua_pushnumber(state, value);
+}
+
+inline void pushArgument(lua_State * state, double value)
+{
+	lua_pushnumber(state, value);
+}
+
+inline void pushArgument(lua_State * state, bool value)
+{
+	lua_pushboolean(state, value);
+}
+
+inline void pushArgument(lua_State * state, const char * value)
+{
+	lua_pushstring(state, value);
+}
+
+inline void pushArgument(lua_State * state, const std::string& value)
+{
+	lua_pushlstring(state, value.data(), value.size());
+}
+
+inline void pushArgument(lua_State * state, const TVector2<float>& value)
+{
+	pushVector2(state, value);
+}
+
+inline void pushArgument(lua_State * state, const TRectangle<float>& value)
+{
+	pushRectangle(state, value);
+}
+
+/**
+ * Read the result of a LuaFunctionRef call, converted like lua_to*()
+ */
+inline void readResult(lua_State * state, int index, int& outValue)
+{
+	outValue = static_cast<int>(lua_tointeger(state, index));
+}
+
+inline void readResult(lua_State * state, int index, float& outValue)
+{
+	outValue = static_cast<float>(lua_tonumber(state, index));
+}
+
+inline void readResult(lua_State * state, int index, double& outValue)
+{
+	outValue = lua_tonumber(state, index);
+}
+
+inline void readResult(lua_State * state, int index, bool& outValue)
+{
+	outValue = lua_toboolean(state, index) != 0;
+}
+
+inline void readResult(lua_State * state, int index, std::string& outValue)
+{
+	size_t length = 0;
+	const char * str = lua_tolstring(state, index, &length);
+	outValue.assign(str ? str : "", str ? length : 0);
+}
+
+/**
+ * A function of a script, e.g. a callback like onUpdate, resolved once
+ * and kept in the registry (luaL_ref). A call then pushes it with a
+ * single lua_rawgeti() instead of looking it up by name, and pushes the
+ * arguments directly from their C++ types.
+ *
+ * The function is resolved again on the next call after the resource
+ * runs a script or gets a new state, e.g. on reload, so the reference
+ * follows the new definition. The calls go through LuaResource::call(),
+ * with its execution limits, and their errors are in getLastError() of
+ * the resource.
+ *
+ * Use it from the thread using the resource, it must not outlive it.
+ */
+class LuaFunctionRef
+{
+	public:
+		LuaFunctionRef();
+		LuaFunctionRef(LuaResource& resource, const LuaPath& path);
+		LuaFunctionRef(LuaFunctionRef&& function);
+		LuaFunctionRef& operator=(LuaFunctionRef&& function);
+		~LuaFunctionRef();
+
+		/**
+		 * @return true if there's a function at the path, resolving it
+		 * if needed
+		 */
+		bool isValid();
+
+		const LuaPath& getPath() const;
+
+		/**
+		 * Call the function, its results are dropped.
+		 * @return false if there's no function or it raised an error
+		 */
+		template<typename ... Args>
+		bool call(const Args&... arguments);
+
+		/**
+		 * Call the function and read its first result.
+		 * @return false if there's no function or it raised an error,
+		 * outResult is then unchanged
+		 */
+		template<typename R, typename ... Args>
+		bool callForResult(R& outResult, const Args&... arguments);
+
+		/**
+		 * Call the function count times, call i getting element i of each
+		 * array, e.g. callBatch(ids.size(), ids.data(), speeds.data()). The
+		 * function is pushed once for the whole batch, each call still
+		 * has the execution limits. A call raising an error doesn't stop
+		 * the others.
+		 * @return the number of calls that succeeded
+		 */
+		template<typename ... Args>
+		size_t callBatch(size_t count, const Args *... arguments);
+
+	private:
+		LuaFunctionRef(const LuaFunctionRef&);
+		LuaFunctionRef& operator=(const LuaFunctionRef&);
+
+		/**
+		 * Push the function, resolved again if the resource changed.
+		 * @return false, with nothing pushed, if there's no function
+		 */
+		bool push();
+
+		/**
+		 * Drop the registry reference, if its state is still there
+		 */
+		void release();
+
+		static int pushArguments(lua_State * state);
+
+		template<typename T, typename ... Rest>
+		static int pushArguments(lua_State * state, const T& first,
+				const Rest&... rest);
+
+		LuaResource * mResource;
+		LuaPath mPath;
+		int mRef; /**< LUA_NOREF when not resolved */
+		unsigned long mStateId; /**< of the state holding mRef */
+		unsigned long mLoadCount; /**< of the resource when resolved */
+};
+
+inline int LuaFunctionRef::pushArguments(lua_State * /*state*/)
+{
+	return 0;
+}
+
+template<typename T, typename ... Rest>
+inline int LuaFunctionRef::pushArguments(lua_State * state, const T& first,
+		const Rest&... rest)
+{
+	pushArgument(state, first);
+	return 1 + pushArguments(state, rest...);
+}
+
+template<typename ... Args>
+inline bool LuaFunctionRef::call(const Args&... arguments)
+{
+	if (!push())
+	{
+		return false;
+	}
+	lua_State * state = mResource->getState();
+	return mResource->call(pushArguments(state, arguments...), 0);
+}
+
+template<typename R, typename ... Args>
+inline bool LuaFunctionRef::callForResult(R& outResult,
+		const Args&... arguments)
+{
+	if (!push())
+	{
+		return false;
+	}
+	lua_State * state = mResource->getState();
+	if (!mResource->call(pushArguments(state, arguments...), 1))
+	{
+		return false;
+	}
+	readResult(state, -1, outResult);
+	lua_pop(state, 1);
+	return true;
+}
+
+template<typename ... Args>
+inline size_t LuaFunctionRef::callBatch(size_t count,
+		const Args *... arguments)
+{
+	if (!push())
+	{
+		return 0;
+	}
+	lua_State * state = mResource->getState();
+	int function = lua_gettop(state);
+
+	size_t succeeded = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		lua_pushvalue(state, function);
+		if (mResource->call(pushArguments(state, arguments[i]...), 0))
+		{
+			++succeeded;
+		}
+	}
+	lua_pop(state, 1);
+	return succeeded;
+}
+
+} /* namespace Util */
+
+#endif /* LUAFUNCTIONREF_H_ */
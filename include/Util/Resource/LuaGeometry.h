@@ -0,0 +1,66 @@
+/*
+ * @file	LuaGeometry.h
+ * @date	2026-10-19
+ * @brief	TVector2 and TRectangle as Lua userdata.
+ */
+
+#ifndef LUAGEOMETRY_H_
+#define LUAGEOMETRY_H_
+
+#include "Util/TVector2.h"
+#include "Util/TRectangle.h"
+
+extern "C"
+{
+#include "lua.h"
+}
+
+#include <cstddef>
+
+namespace Util
+{
+
+/**
+ * Register the geometry types in a state, LuaResource does it for its
+ * scripts. Everything is a full userdata, a vector isn't a table with
+ * two hashed fields:
+ *
+ * Vector2(x, y)         x, y, the operators + - * / unary- ==, tostring
+ *                       and magnitude() normalize() dot(v) cross(v)
+ *                       distance(v) rotate(degrees) copy() unpack().
+ *                       set(x, y), add(v), sub(v) and scale(s) change the
+ *                       vector in place and allocate nothing.
+ * Rectangle(x, y, w, h) x, y, w, h, == and tostring, contains(v) or
+ *                       contains(x, y), getCenter() getDistance(r)
+ *                       getIntersectionDepth(r) set(x, y, w, h) unpack().
+ * Vector2Array(n)       n packed vectors, all zero, #array is n.
+ *                       get(i) gives x, y and set(i, x, y), from 1 to n.
+ *                       Batch functions over all of them, in C:
+ *                       fill(x, y) translate(dx, dy) or translate(v)
+ *                       scale(s) or scale(sx, sy) rotate(degrees)
+ *                       add(array) normalize() bounds() countInside(r).
+ */
+void openGeometry(lua_State * state);
+
+/**
+ * Push a copy as a new Vector2 userdata
+ */
+void pushVector2(lua_State * state, const TVector2<float>& vector);
+void pushRectangle(lua_State * state, const TRectangle<float>& rectangle);
+
+/**
+ * @return the userdata at index, NULL if it isn't one of this type
+ */
+TVector2<float> * toVector2(lua_State * state, int index);
+TRectangle<float> * toRectangle(lua_State * state, int index);
+
+/**
+ * @param outCount number of vectors
+ * @return the packed coordinates, x0 y0 x1 y1..., NULL if it isn't a
+ * Vector2Array
+ */
+float * toVector2Array(lua_State * state, int index, size_t& outCount);
+
+} /* namespace Util */
+
+#endif /* LUAGEOMETRY_H_ */
@@ -0,0 +1,69 @@
+/*
+ * @file	LuaPath.h
+ * @date	2026-10-19
+ * @brief	Compiled path to a value in nested Lua tables.
+ */
+
+#ifndef LUAPATH_H_
+#define LUAPATH_H_
+
+extern "C"
+{
+#include "lua.h"
+}
+
+#include <string>
+#include <vector>
+
+namespace Util
+{
+
+/**
+ * A path like "window.size.width" or "levels[2].name", parsed once.
+ * Reading it walks the tables field by field, with no string splitting
+ * and no allocation. Keep it around and reuse it for every read.
+ *
+ * The first segment is a global name, then each segment is either a
+ * field name after a '.', or an integer index in brackets.
+ */
+class LuaPath
+{
+	public:
+		LuaPath();
+		explicit LuaPath(const std::string& path);
+
+		/**
+		 * @return false if the path couldn't be parsed, nothing is found
+		 * with it then.
+		 */
+		bool isValid() const;
+
+		/**
+		 * @return the path as written in a LuaSnapshot
+		 */
+		const std::string& getKey() const;
+
+		/**
+		 * Push the value at the path on the stack, nil if any table on the
+		 * way is missing.
+		 * @return true if the value isn't nil
+		 */
+		bool push(lua_State * state) const;
+
+	private:
+		struct Segment
+		{
+			std::string field; /**< empty for an index */
+			int index;
+		};
+
+		bool parse(const std::string& path);
+
+		std::vector<Segment> mSegments;
+		std::string mKey;
+		bool mValid;
+};
+
+} /* namespace Util */
+
+#endif /* LUAPATH_H_ */
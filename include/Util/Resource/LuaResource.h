@@ -9,6 +9,11 @@
 #define LUA_RESOURCE_H_
 
 #include "Resource.h"
+#include "ResourceStats.h"
+#include "LuaSnapshot.h"
+#include "LuaPath.h"
+#include "LuaAllocator.h"
+#include "TLuaSchema.h"
 
 extern "C"
 {
@@ -17,27 +22,387 @@ extern "C"
 #include "lauxlib.h"
 }
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <string>
-
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 namespace Util
 {
+
+/**
+ * Figures of the Lua collector of a LuaResource
+ */
+struct LuaGCStats
+{
+	size_t heapSize; /**< bytes used by the Lua state */
+	size_t peakHeapSize;
+	bool manual; /**< only collected by stepGC() */
+	unsigned long stepCount; /**< basic steps run by stepGC() */
+	unsigned long cycleCount; /**< cycles finished by stepGC() */
+	long long totalMicroseconds; /**< spent in stepGC() */
+	LatencyHistogram pauses; /**< duration of each stepGC() */
+};
+
 class LuaResource: public Resource
 {
 	public:
+		typedef std::function<void(const LuaChange&)> ChangeCallback;
+
 		LuaResource();
 		virtual ~LuaResource();
 
 		virtual bool load(const std::string& filename);
+
+		/**
+		 * Execute a script already in memory, getFilename() is used
+		 * as the chunk name in error messages.
+		 */
+		virtual bool loadFromMemory(const char * data, size_t size);
 		void close(void);
 
-		//value getters
-		int getIntValue(const std::string& valueName);
-		std::string getStringValue(const std::string& valueName);
+		/**
+		 * Run the file in a new Lua state, which replaces the current one
+		 * only if the script succeeds. A failing script leaves the state
+		 * and the snapshot as they were. The compiled chunk comes from the
+		 * cache when there's one.
+		 */
+		virtual bool reload();
+
+		/**
+		 * Run the file in a new Lua state on a thread, the current state
+		 * stays in use meanwhile. With the snapshot on, the new snapshot
+		 * replaces the old one as soon as the script succeeded, so the
+		 * getters never block and never see a half-run script. The state
+		 * itself is replaced by commitReload().
+		 * @return false if a reload is already running or there's no file
+		 */
+		bool reloadInBackground();
+
+		/**
+		 * @return true from reloadInBackground() until commitReload()
+		 */
+		bool isReloading() const;
+
+		/**
+		 * Put the state of a finished background reload in place, from the
+		 * thread using the state, e.g. once per frame. A failed reload is
+		 * dropped.
+		 * @param wait for the reload to finish instead of returning false
+		 * @return true if the new state is in place
+		 */
+		bool commitReload(bool wait = false);
+
+		/**
+		 * The filename, the snapshot flag and the execution limits. The
+		 * subscribers, the manual collector and the function references
+		 * stay with this resource.
+		 */
+		virtual void copySettingsTo(Resource& staging) const;
+
+		/**
+		 * Take the state of another LuaResource, like reload() does, and
+		 * tell the subscribers what changed.
+		 */
+		virtual bool swapContent(Resource& staging);
+		virtual bool canSwapContent() const;
+
+		/**
+		 * The compiled chunk of the last load, lua_dump() format, so a
+		 * ResourceCache skips the parsing on the next start, or a
+		 * LuaStatePool parses a script only once for all its states.
+		 * The chunk is dumped by this call, from the thread using the
+		 * state.
+		 */
+		virtual bool serialize(std::string& outData) const;
+		virtual bool canSerialize() const;
+
+		/**
+		 * Run a compiled chunk written by serialize(). Fails without
+		 * running anything if it isn't a chunk this Lua can load.
+		 */
+		virtual bool deserialize(const char * data, size_t size);
+
+		/**
+		 * DESERIALIZE_FAILED once the chunk ran, the script isn't run a
+		 * second time by load() in the same state.
+		 */
+		virtual DeserializeResult deserializeEntry(const char * data,
+				size_t size);
+
+		/**
+		 * The Lua version, the compiled chunks depend on it.
+		 */
+		virtual unsigned int getLoaderVersion() const;
+
+		/**
+		 * Includes the memory reserved by the Lua state.
+		 */
+		virtual size_t getMemorySize() const;
+
+		/**
+		 * The state runs on its own arena, see LuaAllocator for the
+		 * memory counters.
+		 */
+		const LuaAllocator& getAllocator() const;
+
+		/**
+		 * To call Lua directly, from one thread at a time.
+		 */
+		lua_State * getState() const;
+
+		/**
+		 * Value getters, read in the snapshot when it is on, in the Lua
+		 * state otherwise. 0 or "" when the global isn't set, or when the
+		 * snapshot is on but no load succeeded yet.
+		 */
+		int getIntValue(const std::string& valueName) const;
+		std::string getStringValue(const std::string& valueName) const;
+
+		/**
+		 * Read a value in nested tables, in the snapshot when it is on.
+		 * @return the value converted like lua_to*(), defaultValue if there's
+		 * nothing at the path
+		 */
+		int getInt(const LuaPath& path, int defaultValue = 0) const;
+		float getFloat(const LuaPath& path, float defaultValue = 0.0f) const;
+		bool getBool(const LuaPath& path, bool defaultValue = false) const;
+		std::string getString(const LuaPath& path,
+				const std::string& defaultValue = "") const;
+
+		/**
+		 * Fill a struct from the table at path, in one traversal of the
+		 * table in the Lua state. Always reads the state, never the
+		 * snapshot: call it from the thread using the state, like
+		 * getState(). After a failed load it sees what the script set
+		 * before failing.
+		 * @return false if there's no table at path
+		 */
+		template<typename S>
+		bool bind(const LuaPath& path, const TLuaSchema<S>& schema,
+				S& out) const;
+
+		/**
+		 * Fill a struct per element of the array at path, from the state
+		 * like bind().
+		 * @return false if there's no table at path
+		 */
+		template<typename S>
+		bool bindArray(const LuaPath& path, const TLuaSchema<S>& schema,
+				std::vector<S>& out) const;
+
+		/**
+		 * Snapshot used by the resources created afterwards, e.g. by a
+		 * TResourceManager. Off by default.
+		 */
+		static void setSnapshotByDefault(bool enabled);
+
+		/**
+		 * Copy the globals set by the script in a LuaSnapshot after each
+		 * successful load, a failed load keeps the previous one. The
+		 * getters then never touch the Lua state and can be called from
+		 * any thread. Turn it on or off before sharing the resource.
+		 */
+		void setSnapshotEnabled(bool enabled);
+		bool isSnapshotEnabled() const;
+
+		/**
+		 * Copy the globals again, e.g. after changing them from C++.
+		 */
+		void updateSnapshot();
+
+		/**
+		 * The pointer can be kept, the snapshot stays the same even if the
+		 * resource is loaded again.
+		 * @return the values of the last successful load, NULL without
+		 * snapshot
+		 */
+		std::shared_ptr<const LuaSnapshot> getSnapshot() const;
+
+		/**
+		 * Call callback for each value that changed under prefix when the
+		 * snapshot is replaced: by a load, a reload, commitReload() or
+		 * updateSnapshot(). The calls are made on the thread doing it, in
+		 * the order of the paths. Turns the snapshot on, the changes are
+		 * found by comparing the old and the new one.
+		 * @param prefix a path like "window" gets "window.width" and
+		 * "window[1]" but not "windows", empty for every value
+		 * @return the id for unsubscribe()
+		 */
+		unsigned int subscribe(const std::string& prefix,
+				ChangeCallback callback);
+		void unsubscribe(unsigned int id);
+
+		/**
+		 * Stop the automatic collector, which runs whenever Lua allocates
+		 * and may then take milliseconds. The garbage is only collected by
+		 * stepGC() afterwards, the scripts run by a load still have the
+		 * automatic one.
+		 */
+		void setManualGC(bool manual);
+		bool isManualGC() const;
+
+		/**
+		 * Run small incremental steps of the collector until the budget is
+		 * spent or a cycle ends, e.g. once per frame. The last step may go
+		 * over the budget by the time of one step, a few microseconds.
+		 * @return true if a cycle ended
+		 */
+		bool stepGC(long long budgetMicroseconds);
+
+		LuaGCStats getGCStats() const;
+		void clearGCStats();
+
+		/**
+		 * Limits used by the resources created afterwards, e.g. by a
+		 * TResourceManager. None by default.
+		 */
+		static void setExecutionLimitsByDefault(unsigned long maxInstructions,
+				long long maxMicroseconds);
+
+		/**
+		 * Abort the scripts run by a load, or by call(), that go over a
+		 * number of Lua instructions or a duration, 0 for no limit. They are
+		 * checked every HOOK_INTERVAL instructions by a count hook, a long
+		 * call to a C function, e.g. string.rep(), isn't interrupted.
+		 */
+		void setExecutionLimits(unsigned long maxInstructions,
+				long long maxMicroseconds);
+		unsigned long getMaxInstructions() const;
+		long long getMaxMicroseconds() const;
+
+		/**
+		 * lua_pcall() with the execution limits, the function and its
+		 * arguments must be on the stack of getState().
+		 * @return false on error, nothing is then left on the stack and
+		 * the message is in getLastError()
+		 */
+		bool call(int argumentCount, int resultCount);
+
+		/**
+		 * The error of the last load or call(), with the position in the
+		 * script, empty if it succeeded.
+		 */
+		const std::string& getLastError() const;
+
+		/**
+		 * Instructions between two checks of the limits
+		 */
+		static const int HOOK_INTERVAL = 1000;
 
 	private:
+		friend class LuaFunctionRef;
+
+		struct Subscription
+		{
+			unsigned int id;
+			std::string prefix;
+			ChangeCallback callback;
+		};
+
+		static bool matchesPrefix(const std::string& path,
+				const std::string& prefix);
+
+		/**
+		 * Tell the subscribers what changed since the last snapshot they
+		 * were told about, if the snapshot is not the same.
+		 */
+		void notifyChanges();
+
+		/**
+		 * Keep a reference to the chunk on top of the stack, if it loaded,
+		 * for serialize()
+		 * @return loadStatus
+		 */
+		int keepChunk(int loadStatus);
+
+		/**
+		 * Name of the chunks loaded from memory, for the error messages
+		 */
+		std::string getChunkName() const;
+
+		/**
+		 * Open the standard libraries and the geometry types of
+		 * LuaGeometry.h, with the collector stopped
+		 */
+		void openLibs();
+
+		/**
+		 * Run the chunk on top of the stack and report the errors
+		 * @param loadStatus returned by the luaL_load* function
+		 * @return true if the chunk was loaded and ran without error
+		 */
+		bool execute(int loadStatus);
+
+		/**
+		 * Move the error message on top of the stack to mLastError
+		 */
+		void popError();
+
+		/**
+		 * Take the state, the compiled chunk and the snapshot of another
+		 * resource, it gets the current ones.
+		 */
+		void swapState(LuaResource& other);
+
+		/**
+		 * Wait for the reload thread, if any, and drop what it loaded.
+		 */
+		void cancelReload();
+
+		LuaAllocator * mAllocator; /**< owned, outlives mFile */
 		lua_State* mFile;
+		unsigned long mStateId; /**< unique, follows mFile */
+		unsigned long mLoadCount; /**< scripts run in mFile */
+		int mChunkRef; /**< registry reference to the last chunk loaded */
+
+		/**
+		 * Globals of the standard libraries, not in the snapshot
+		 */
+		std::unordered_set<std::string> mLibraryGlobals;
+		bool mSnapshotEnabled;
+		std::shared_ptr<const LuaSnapshot> mSnapshot; /**< atomic access */
+		std::vector<Subscription> mSubscriptions;
+		unsigned int mNextSubscriptionId;
+		std::shared_ptr<const LuaSnapshot> mNotifiedSnapshot;
+		bool mManualGC;
+		LuaGCStats mGCStats; /**< only the stepGC() figures */
+		unsigned long mMaxInstructions;
+		long long mMaxMicroseconds;
+		std::string mLastError;
+
+		LuaResource * mStaging; /**< loaded by mReloadThread, NULL if none */
+		std::thread mReloadThread;
+		std::atomic<bool> mReloadDone;
+		bool mReloadSucceeded; /**< set before mReloadDone */
+
+		static bool sSnapshotByDefault;
+		static unsigned long sDefaultMaxInstructions;
+		static long long sDefaultMaxMicroseconds;
 };
 
+template<typename S>
+inline bool LuaResource::bind(const LuaPath& path, const TLuaSchema<S>& schema,
+		S& out) const
+{
+	path.push(mFile);
+	bool success = schema.read(mFile, -1, out);
+	lua_pop(mFile, 1);
+	return success;
+}
+
+template<typename S>
+inline bool LuaResource::bindArray(const LuaPath& path,
+		const TLuaSchema<S>& schema, std::vector<S>& out) const
+{
+	path.push(mFile);
+	bool success = schema.readArray(mFile, -1, out);
+	lua_pop(mFile, 1);
+	return success;
+}
+
 } /* namespace Util */
 #endif /* LUA_RESOURCE_H_ */
@@ -0,0 +1,138 @@
+/*
+ * @file	LuaSnapshot.h
+ * @date	2026-10-19
+ * @brief	Native copy of the values set by a Lua config script.
+ */
+
+#ifndef LUASNAPSHOT_H_
+#define LUASNAPSHOT_H_
+
+extern "C"
+{
+#include "lua.h"
+}
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Util
+{
+
+/**
+ * A Lua value copied out of the state. A table only keeps its length,
+ * its content has its own entries.
+ */
+struct LuaValue
+{
+	enum Type
+	{
+		NIL, BOOLEAN, NUMBER, STRING, TABLE
+	};
+
+	LuaValue();
+
+	/**
+	 * Same conversions as lua_tointeger, lua_tonumber, lua_toboolean and
+	 * lua_tostring, a number is formatted like Lua does.
+	 */
+	int toInt() const;
+	double toNumber() const;
+	bool toBool() const;
+	std::string toString() const;
+
+	bool operator==(const LuaValue& v2) const;
+	bool operator!=(const LuaValue& v2) const;
+
+	Type type;
+	bool boolean;
+	double number; /**< the length for a table */
+	std::string string;
+};
+
+/**
+ * A value that differs between two snapshots
+ */
+struct LuaChange
+{
+	enum Type
+	{
+		ADDED, REMOVED, CHANGED
+	};
+
+	Type type;
+	std::string path;
+	LuaValue oldValue; /**< NIL when added */
+	LuaValue newValue; /**< NIL when removed */
+};
+
+/**
+ * Every value reachable from the globals set by a script, flattened in a
+ * hash table. The keys are paths: "window.width" for a field, "levels[2]"
+ * for an array element, "levels[2].name" for both.
+ *
+ * A snapshot is never modified once built, any number of threads can read
+ * it without locking, without touching the Lua state.
+ */
+class LuaSnapshot
+{
+	public:
+		typedef std::unordered_map<std::string, LuaValue> ValueMap;
+
+		LuaSnapshot();
+
+		/**
+		 * Copy the globals of a state, except the ones in ignoredGlobals,
+		 * usually the standard libraries. Functions, userdata and threads
+		 * are skipped, a table inside itself isn't copied again.
+		 */
+		void build(lua_State * state,
+				const std::unordered_set<std::string>& ignoredGlobals);
+
+		/**
+		 * @return the value at path, NULL if none
+		 */
+		const LuaValue * find(const std::string& path) const;
+		bool has(const std::string& path) const;
+
+		/**
+		 * @return the value at path converted, defaultValue if none
+		 */
+		int getInt(const std::string& path, int defaultValue = 0) const;
+		double getNumber(const std::string& path, double defaultValue = 0.0) const;
+		bool getBool(const std::string& path, bool defaultValue = false) const;
+		std::string getString(const std::string& path,
+				const std::string& defaultValue = "") const;
+
+		size_t size() const;
+		const ValueMap& getValues() const;
+
+		/**
+		 * Append what changed since a previous snapshot, sorted by path. A
+		 * table counts as changed when its length did.
+		 * @param previous NULL if there was none, everything is then added
+		 */
+		void diff(const LuaSnapshot * previous,
+				std::vector<LuaChange>& outChanges) const;
+
+		/**
+		 * Tables nested deeper than this are not copied
+		 */
+		static const int MAX_DEPTH = 32;
+
+	private:
+		/**
+		 * Copy the value on top of the stack at path, and its content if
+		 * it's a table.
+		 */
+		void addValue(lua_State * state, const std::string& path, int depth,
+				std::unordered_set<const void *>& parentTables);
+
+		ValueMap mValues;
+};
+
+} /* namespace Util */
+
+#endif /* LUASNAPSHOT_H_ */
@@ -0,0 +1,155 @@
+/*
+ * @file	LuaStatePool.h
+ * @date	2026-10-19
+ * @brief	Lua states with the same scripts, shared by worker threads.
+ */
+
+#ifndef LUASTATEPOOL_H_
+#define LUASTATEPOOL_H_
+
+#include "LuaResource.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+namespace Util
+{
+
+/**
+ * A lua_State can only be used by one thread at a time. The pool keeps
+ * several LuaResource with the same scripts loaded, a thread checks one
+ * out with acquire() and gives it back when the Lease is destroyed:
+ *
+ * LuaStatePool pool; // one state per core
+ * pool.load("rules.lua");
+ * [...]
+ * // in any thread
+ * LuaStatePool::Lease lease = pool.acquire();
+ * lua_State * state = lease->getState();
+ *
+ * Each thread gets a home state the first time and goes back to it while
+ * it is free, so threads don't compete for the same states and a state
+ * stays in the cache of the same core.
+ *
+ * load() and loadFromMemory() must not be called while a state is out.
+ */
+class LuaStatePool
+{
+	public:
+		/**
+		 * Checked out state, given back to the pool by the destructor.
+		 */
+		class Lease
+		{
+			public:
+				Lease();
+				Lease(Lease&& lease);
+				Lease& operator=(Lease&& lease);
+				~Lease();
+
+				/**
+				 * @return false for a default constructed or moved lease, or
+				 * when tryAcquire() found nothing free.
+				 */
+				bool isValid() const;
+
+				LuaResource& getResource() const;
+				LuaResource * operator->() const;
+
+				/**
+				 * Give the state back now
+				 */
+				void release();
+
+			private:
+				friend class LuaStatePool;
+				Lease(LuaStatePool * pool, unsigned int index);
+				Lease(const Lease&);
+				Lease& operator=(const Lease&);
+
+				LuaStatePool * mPool;
+				unsigned int mIndex;
+		};
+
+		/**
+		 * @param stateCount number of states, 0 for one per core
+		 */
+		explicit LuaStatePool(unsigned int stateCount = 0);
+		~LuaStatePool();
+
+		/**
+		 * Run a script in every state. It is parsed once, the other
+		 * states run its compiled chunk.
+		 * @return true if it ran without error in all the states
+		 */
+		bool load(const std::string& filename);
+		bool loadFromMemory(const char * data, size_t size);
+
+		/**
+		 * Check out a state, waits for one if they are all out.
+		 */
+		Lease acquire();
+
+		/**
+		 * Check out a state, without waiting.
+		 */
+		Lease tryAcquire();
+
+		unsigned int getStateCount() const;
+
+		/**
+		 * @return how many acquire() didn't get the home state of their
+		 * thread, a measure of the contention.
+		 */
+		unsigned long getMissCount() const;
+
+	private:
+		LuaStatePool(const LuaStatePool&);
+		LuaStatePool& operator=(const LuaStatePool&);
+
+		/**
+		 * Aligned so two states checked out by two threads aren't on
+		 * the same cache line
+		 */
+		struct alignas(64) Slot
+		{
+			LuaResource * resource;
+			std::atomic<bool> busy;
+		};
+
+		/**
+		 * Run the compiled chunk of the first state in the others
+		 */
+		bool copyToOthers(bool loaded);
+
+		/**
+		 * @return the index of a state now busy, or getStateCount()
+		 */
+		unsigned int tryTake();
+
+		void giveBack(unsigned int index);
+
+		/**
+		 * @return the state this thread prefers
+		 */
+		unsigned int getHomeIndex();
+
+		Slot * mSlots; /**< in mSlotStorage, on a cache line boundary */
+		char * mSlotStorage;
+		unsigned int mStateCount;
+		std::atomic<unsigned int> mNextHome; /**< spreads the threads */
+		std::atomic<unsigned long> mMissCount;
+
+		std::mutex mMutex; /**< only to wait for a free state */
+		std::condition_variable mFreed;
+		std::atomic<unsigned int> mWaiting;
+
+		unsigned int mId; /**< tells the pools apart in the threads */
+		static std::atomic<unsigned int> sNextId;
+};
+
+} /* namespace Util */
+
+#endif /* LUASTATEPOOL_H_ */
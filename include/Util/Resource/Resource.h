@@ -13,12 +13,25 @@
 #define RESOURCE_H_
 
 #include <string>
+#include <cstddef>
+#include <istream>
 
 namespace Util {
 
+class ResourceCache;
+
 class Resource {
 public:
 
+	/**
+	 * What deserializeEntry() did with a cache entry
+	 */
+	enum DeserializeResult {
+		DESERIALIZE_REJECTED, /**< unusable, the resource didn't change */
+		DESERIALIZE_FAILED, /**< used, but failed, e.g. a script error */
+		DESERIALIZE_LOADED
+	};
+
 	/**
 	 * Default constructor
 	 */
@@ -33,11 +46,107 @@ public:
 	virtual bool load(const std::string& filename) = 0;
 
 	/**
-	 * Reload the resource
+	 * Load the resource from bytes already in memory, e.g. extracted from
+	 * an archive or received from the network. The data is only read
+	 * during the call. The default implementation returns false.
+	 * @param data the content, as it would be in a file
+	 * @param size in bytes
+	 * @return true if it loaded correctly, false otherwise.
+	 */
+	virtual bool loadFromMemory(const char * data, size_t size);
+
+	/**
+	 * Load the resource from what's left in a stream. The default
+	 * implementation reads it all with readStream() and calls
+	 * loadFromMemory, which may copy the bytes once more. Override it
+	 * to keep the buffer read instead, see TextResource.
+	 * @param stream opened in binary mode preferably
+	 * @return true if it loaded correctly, false otherwise.
+	 */
+	virtual bool loadFromStream(std::istream& stream);
+
+	/**
+	 * Reload the resource, through the cache if there's one
 	 * @return false on failed attempt
 	 */
 	virtual bool reload();
 
+	/**
+	 * Give a new resource of the same type what it needs to load the
+	 * file of this one like this one would: the filename, the cache and
+	 * the settings of the sub-class, e.g. a compression flag.
+	 * Sub-classes with settings must call this implementation too.
+	 * @param staging the resource that will load the file
+	 */
+	virtual void copySettingsTo(Resource& staging) const;
+
+	/**
+	 * Take the content of staging, loaded after copySettingsTo(), and
+	 * give it the current content. This object keeps its settings and
+	 * the pointers to it stay valid, only what was loaded changes.
+	 * The default implementation doesn't support it.
+	 * @param staging a loaded resource of the same type
+	 * @return false if nothing was swapped
+	 */
+	virtual bool swapContent(Resource& staging);
+
+	/**
+	 * Tells TResourceManager::reloadAll(ThreadPool&) whether to load a
+	 * staging copy and swapContent() it in, or to reload() in place.
+	 * Must return true when swapContent() is overridden.
+	 * @return false by default
+	 */
+	virtual bool canSwapContent() const;
+
+	/**
+	 * Approximate number of bytes held in memory by this resource.
+	 * Sub-classes should add the size of the data they own so the
+	 * manager can keep track of its memory budget.
+	 * @return the size in bytes
+	 */
+	virtual size_t getMemorySize() const;
+
+	/**
+	 * Write the processed form of the resource, the one that is long to
+	 * build from the source file, so deserialize can rebuild it later.
+	 * The default implementation doesn't support caching.
+	 * @param outData receives the bytes
+	 * @return false if the resource can't be cached
+	 */
+	virtual bool serialize(std::string& outData) const;
+
+	/**
+	 * Whether serialize() can succeed with the current settings, asked
+	 * before the load so a ResourceCache doesn't hash the source of a
+	 * resource it can't cache.
+	 * @return false by default
+	 */
+	virtual bool canSerialize() const;
+
+	/**
+	 * Rebuild the resource from what serialize wrote, instead of load.
+	 * The data usually points into a memory mapped cache file which is
+	 * closed after the call, copy what you need to keep.
+	 * Must call setLoaded(true) on success.
+	 * @return false if the data can't be used, load is then called.
+	 */
+	virtual bool deserialize(const char * data, size_t size);
+
+	/**
+	 * deserialize() as seen by a ResourceCache, which calls load() only
+	 * after a rejected entry. The default takes false as a rejection,
+	 * override it when deserialize() can fail after changing the
+	 * resource, so the work isn't done twice.
+	 */
+	virtual DeserializeResult deserializeEntry(const char * data,
+			size_t size);
+
+	/**
+	 * Change it whenever the format written by serialize changes,
+	 * the older cache entries are then ignored.
+	 */
+	virtual unsigned int getLoaderVersion() const;
+
 	/**
 	 * GETTER / SETTER
 	 */
@@ -45,12 +154,33 @@ public:
 	void setFilename(const std::string& filename);
 	bool isLoaded() const;
 
+	/**
+	 * Cache used by reload(), set by TResourceManager::setCache.
+	 * @param cache not owned, NULL to load from the file only (default)
+	 */
+	void setCache(ResourceCache * cache);
+	ResourceCache * getCache() const;
+
 protected:
 
 	void setLoaded(bool loaded);
 
+	/**
+	 * Read what's left in a stream. A seekable stream is read at once in
+	 * a buffer of its size, others in chunks.
+	 * @param outData receives the bytes
+	 * @return false if the stream went bad
+	 */
+	static bool readStream(std::istream& stream, std::string& outData);
+
+	/**
+	 * load(), or deserialize() from the cache entry if it is valid
+	 */
+	bool loadCached(const std::string& filename);
+
 	std::string mFilename; /**< the filename and path if necessary to access the resource */
 	bool mLoaded; /**< loading flag */
+	ResourceCache * mCache; /**< not owned, can be NULL */
 };
 
 } // namespace Util
@@ -0,0 +1,91 @@
+/*
+ * @file	ResourceCache.h
+ * @date	2026-10-19
+ * @brief	Persistent on-disk cache of processed resources.
+ */
+
+#ifndef RESOURCECACHE_H_
+#define RESOURCECACHE_H_
+
+#include "Resource.h"
+
+#include <atomic>
+#include <string>
+
+namespace Util
+{
+
+/**
+ * Keeps what Resource::serialize writes in a directory, so the next
+ * process can rebuild the resource with Resource::deserialize instead of
+ * processing the source file again.
+ *
+ * An entry is used only if it was written for the same resource type,
+ * source path, source content hash and Resource::getLoaderVersion().
+ * Otherwise the resource is loaded from the source and the entry is
+ * written again. An entry that was used but failed, see
+ * Resource::deserializeEntry, isn't followed by a load from the source.
+ *
+ * To use it with a manager:
+ * ResourceCache cache("cache");
+ * TResourceManager<YourResourceSubClass>::getInstance()->setCache(&cache);
+ *
+ * Different resources can be loaded from different threads at the same
+ * time, e.g. by TResourceManager::reloadAll(ThreadPool&).
+ */
+class ResourceCache
+{
+	public:
+		/**
+		 * @param directory where the entries are stored, it is created
+		 * if it doesn't exist.
+		 */
+		explicit ResourceCache(const std::string& directory);
+		~ResourceCache();
+
+		/**
+		 * Load the resource from its cache entry if it is valid, from
+		 * the source file otherwise and then update the entry. A
+		 * resource that can't serialize is loaded from the source,
+		 * without hashing it, and doesn't count as a miss.
+		 * @param resource to load
+		 * @param filename of the source
+		 * @return true if the resource is loaded, one way or the other.
+		 */
+		bool load(Resource& resource, const std::string& filename);
+
+		/**
+		 * @return the path of the entry file of a resource
+		 */
+		std::string getEntryFilename(const Resource& resource,
+				const std::string& filename) const;
+
+		const std::string& getDirectory() const;
+
+		unsigned long getHitCount() const; /**< deserialized from an entry */
+		unsigned long getMissCount() const; /**< loaded from the source */
+
+	private:
+		/**
+		 * Try to deserialize from the entry
+		 * @return DESERIALIZE_REJECTED if the entry is missing, stale or
+		 * unusable
+		 */
+		Resource::DeserializeResult fetch(Resource& resource,
+				const std::string& entryFilename, const std::string& key,
+				unsigned long long contentHash);
+
+		/**
+		 * Write the entry of a loaded resource, if it can be serialized.
+		 */
+		void store(const Resource& resource, const std::string& entryFilename,
+				const std::string& key, unsigned long long contentHash);
+
+		std::string mDirectory;
+		std::atomic<unsigned long> mHitCount;
+		std::atomic<unsigned long> mMissCount;
+};
+
+} /* namespace Util */
+
+#endif /* RESOURCECACHE_H_ */
@@ -0,0 +1,100 @@
+/**
+ *  @file		ResourceStats.h
+ *  @brief     	Reports given by the TResourceManager.
+ *  @details	TResourceManager<T>::getStats() fills a ResourceManagerStats,
+ *  			a copy of the counters at the time of the call.
+ *
+ *  @date      	2026-10-19
+ *  @copyright 	Prismal Studio 2008-2013 www.prismalstudio.com
+ */
+
+#ifndef RESOURCESTATS_H_
+#define RESOURCESTATS_H_
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+
+namespace Util {
+
+/**
+ * Outcome of the reload of a single resource
+ */
+struct ResourceReloadResult {
+	std::string filename;
+	bool success;
+	bool skipped; /**< not reloaded at all, success is false */
+	long long microseconds; /**< time spent in load() */
+};
+
+/**
+ * Counts durations in power of two buckets of microseconds.
+ * Bucket 0 holds [0, 2), bucket i holds [2^i, 2^(i+1)).
+ */
+class LatencyHistogram {
+public:
+	static const int BUCKET_COUNT = 32;
+
+	LatencyHistogram();
+
+	void add(long long microseconds);
+	void clear();
+
+	unsigned long getCount() const;
+	unsigned long getBucket(int bucket) const;
+	long long getMax() const;
+	double getAverage() const;
+
+	/**
+	 * @param ratio between 0 and 1, 0.99 for the 99th percentile
+	 * @return the upper bound of the bucket holding the percentile
+	 */
+	long long getPercentile(double ratio) const;
+
+private:
+	unsigned long mBuckets[BUCKET_COUNT];
+	unsigned long mCount;
+	long long mTotal;
+	long long mMax;
+};
+
+/**
+ * Figures of a single managed resource
+ */
+struct ResourceStats {
+	std::string filename;
+	size_t bytes; /**< getMemorySize() after the last (re)load */
+	long long loadMicroseconds; /**< 0 if registered from outside */
+	long long reloadMicroseconds; /**< last reload, 0 if never reloaded */
+	unsigned long reloadCount;
+	unsigned long reloadFailureCount; /**< the previous content was kept */
+	unsigned long hitCount; /**< times load() found it already loaded */
+	bool pinned;
+	unsigned int refCount;
+};
+
+/**
+ * Snapshot of a whole manager
+ */
+struct ResourceManagerStats {
+	unsigned long hitCount;
+	unsigned long missCount;
+	unsigned long evictCount;
+	size_t memoryUsage;
+	size_t memoryBudget;
+	LatencyHistogram loadLatency;
+	LatencyHistogram reloadLatency;
+	std::vector<ResourceStats> resources; /**< in no particular order */
+};
+
+/**
+ * @return the microseconds elapsed since start
+ */
+inline long long microsecondsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace Util
+#endif /* RESOURCESTATS_H_ */
@@ -0,0 +1,305 @@
+/**
+ *  @file		TLuaSchema.h
+ *  @brief     	Fills C++ structs from Lua tables, a field list at a time.
+ *  @details	The fields of a struct are registered once, with the name of
+ *  			their key in the Lua table:
+ *
+ *  			struct Enemy { std::string name; int health; float speed; };
+ *
+ *  			TLuaSchema<Enemy> schema;
+ *  			schema.addField("name", &Enemy::name)
+ *  					.addField("health", &Enemy::health)
+ *  					.addField("speed", &Enemy::speed);
+ *
+ *  			std::vector<Enemy> enemies;
+ *  			luaResource.bindArray(LuaPath("enemies"), schema, enemies);
+ *
+ *  			A table is read in a single lua_next() traversal, each key
+ *  			found goes to its field. The fields without a key, or with a
+ *  			value of the wrong type, keep their value.
+ *
+ *  @date      	2026-10-19
+ *  @pre		S must be default constructible
+ *  @copyright 	Prismal Studio 2008-2013 www.prismalstudio.com
+ */
+
+#ifndef TLUASCHEMA_H_
+#define TLUASCHEMA_H_
+
+extern "C"
+{
+#include "lua.h"
+}
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Util
+{
+
+template<typename S>
+class TLuaSchema
+{
+	public:
+		/**
+		 * A number, or a string holding one
+		 */
+		TLuaSchema& addField(const std::string& name, int S::*member);
+		TLuaSchema& addField(const std::string& name, float S::*member);
+		TLuaSchema& addField(const std::string& name, double S::*member);
+
+		/**
+		 * Only a boolean
+		 */
+		TLuaSchema& addField(const std::string& name, bool S::*member);
+
+		/**
+		 * A string, or a number converted like lua_tostring does
+		 */
+		TLuaSchema& addField(const std::string& name, std::string S::*member);
+
+		/**
+		 * A table read with another schema, which is copied.
+		 */
+		template<typename Sub>
+		TLuaSchema& addField(const std::string& name, Sub S::*member,
+				const TLuaSchema<Sub>& schema);
+
+		/**
+		 * An array of tables read with another schema, which is copied.
+		 */
+		template<typename Sub>
+		TLuaSchema& addArrayField(const std::string& name,
+				std::vector<Sub> S::*member, const TLuaSchema<Sub>& schema);
+
+		size_t getFieldCount() const;
+
+		/**
+		 * Fill out from the table at index.
+		 * @return false if it isn't a table, out is unchanged then
+		 */
+		bool read(lua_State * state, int index, S& out) const;
+
+		/**
+		 * Fill out with an element per entry of the array at index, from
+		 * [1] to its length. out is resized, the elements which aren't
+		 * tables stay default constructed.
+		 * @return false if it isn't a table, out is unchanged then
+		 */
+		bool readArray(lua_State * state, int index, std::vector<S>& out) const;
+
+	private:
+		/**
+		 * Read the value on top of the stack in its member
+		 */
+		typedef std::function<void(lua_State *, S&)> Reader;
+
+		struct Field
+		{
+			std::string name;
+			Reader reader;
+		};
+
+		TLuaSchema& add(const std::string& name, const Reader& reader);
+
+		/**
+		 * Linear, a struct has few fields and most keys are short
+		 */
+		const Field * findField(const char * key, size_t length) const;
+
+		/**
+		 * Index that stays valid when the stack grows
+		 */
+		static int absoluteIndex(lua_State * state, int index);
+
+		std::vector<Field> mFields;
+};
+
+template<typename S>
+inline TLuaSchema<S>& TLuaSchema<S>::addField(const std::string& name,
+		int S::*member)
+{
+	return add(name, [member](lua_State * state, S& out)
+	{
+		if (lua_isnumber(state, -1))
+		{
+			out.*member = static_cast<int>(lua_tointeger(state, -1));
+		}
+	});
+}
+
+template<typename S>
+inline TLuaSchema<S>& TLuaSchema<S>::addField(const std::string& name,
+		float S::*member)
+{
+	return add(name, [member](lua_State * state, S& out)
+	{
+		if (lua_isnumber(state, -1))
+		{
+			out.*member = static_cast<float>(lua_tonumber(state, -1));
+		}
+	});
+}
+
+template<typename S>
+inline TLuaSchema<S>& TLuaSchema<S>::addField(const std::string& name,
+		double S::*member)
+{
+	return add(name, [member](lua_State * state, S& out)
+	{
+		if (lua_isnumber(state, -1))
+		{
+			out.*member = lua_tonumber(state, -1);
+		}
+	});
+}
+
+template<typename S>
+inline TLuaSchema<S>& TLuaSchema<S>::addField(const std::string& name,
+		bool S::*member)
+{
+	return add(name, [member](lua_State * state, S& out)
+	{
+		if (lua_isboolean(state, -1))
+		{
+			out.*member = lua_toboolean(state, -1) != 0;
+		}
+	});
+}
+
+template<typename S>
+inline TLuaSchema<S>& TLuaSchema<S>::addField(const std::string& name,
+		std::string S::*member)
+{
+	return add(name, [member](lua_State * state, S& out)
+	{
+		// the value, not the key, lua_tolstring() may convert it
+		if (lua_isstring(state, -1))
+		{
+			size_t length = 0;
+			const char * str = lua_tolstring(state, -1, &length);
+			(out.*member).assign(str, length);
+		}
+	});
+}
+
+template<typename S>
+template<typename Sub>
+inline TLuaSchema<S>& TLuaSchema<S>::addField(const std::string& name,
+		Sub S::*member, const TLuaSchema<Sub>& schema)
+{
+	return add(name, [member, schema](lua_State * state, S& out)
+	{
+		schema.read(state, -1, out.*member);
+	});
+}
+
+template<typename S>
+template<typename Sub>
+inline TLuaSchema<S>& TLuaSchema<S>::addArrayField(const std::string& name,
+		std::vector<Sub> S::*member, const TLuaSchema<Sub>& schema)
+{
+	return add(name, [member, schema](lua_State * state, S& out)
+	{
+		schema.readArray(state, -1, out.*member);
+	});
+}
+
+template<typename S>
+inline size_t TLuaSchema<S>::getFieldCount() const
+{
+	return mFields.size();
+}
+
+template<typename S>
+inline bool TLuaSchema<S>::read(lua_State * state, int index, S& out) const
+{
+	if (!lua_istable(state, index))
+	{
+		return false;
+	}
+	index = absoluteIndex(state, index);
+
+	lua_checkstack(state, 3);
+	lua_pushnil(state);
+	while (lua_next(state, index) != 0)
+	{
+		// lua_tolstring() on a number key would confuse lua_next()
+		if (lua_type(state, -2) == LUA_TSTRING)
+		{
+			size_t length = 0;
+			const char * key = lua_tolstring(state, -2, &length);
+			const Field * field = findField(key, length);
+			if (field)
+			{
+				field->reader(state, out);
+			}
+		}
+		lua_pop(state, 1);
+	}
+	return true;
+}
+
+template<typename S>
+inline bool TLuaSchema<S>::readArray(lua_State * state, int index,
+		std::vector<S>& out) const
+{
+	if (!lua_istable(state, index))
+	{
+		return false;
+	}
+	index = absoluteIndex(state, index);
+
+	size_t count = lua_objlen(state, index);
+	out.clear();
+	out.resize(count);
+
+	lua_checkstack(state, 4);
+	for (size_t i = 0; i < count; ++i)
+	{
+		lua_rawgeti(state, index, static_cast<int>(i + 1));
+		read(state, -1, out[i]);
+		lua_pop(state, 1);
+	}
+	return true;
+}
+
+template<typename S>
+inline TLuaSchema<S>& TLuaSchema<S>::add(const std::string& name,
+		const Reader& reader)
+{
+	Field field;
+	field.name = name;
+	field.reader = reader;
+	mFields.push_back(field);
+	return *this;
+}
+
+template<typename S>
+inline const typename TLuaSchema<S>::Field * TLuaSchema<S>::findField(
+		const char * key, size_t length) const
+{
+	for (size_t i = 0; i < mFields.size(); ++i)
+	{
+		const std::string& name = mFields[i].name;
+		if (name.size() == length && std::memcmp(name.data(), key, length) == 0)
+		{
+			return &mFields[i];
+		}
+	}
+	return NULL;
+}
+
+template<typename S>
+inline int TLuaSchema<S>::absoluteIndex(lua_State * state, int index)
+{
+	// the pseudo-indices, like LUA_GLOBALSINDEX, are absolute already
+	return (index < 0 && index > LUA_REGISTRYINDEX) ?
+			lua_gettop(state) + index + 1 : index;
+}
+
+} /* namespace Util */
+
+#endif /* TLUASCHEMA_H_ */
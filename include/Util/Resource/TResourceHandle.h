@@ -0,0 +1,82 @@
+/**
+ *  @file		TResourceHandle.h
+ *  @brief     	Weak reference to a resource held by a TResourceManager.
+ *  @details	A handle is an index in the manager's slot array with the
+ *  			generation of the slot at the time the handle was given.
+ *  			When a resource is deleted, evicted or unregistered, the
+ *  			generation of its slot is incremented so every handle to it
+ *  			becomes stale. TResourceManager<T>::get() returns NULL for
+ *  			a stale handle instead of a dangling pointer.
+ *
+ *  			A default constructed handle is null and never valid.
+ *
+ *  @date      	2026-10-19
+ *  @pre		a class that inherit from Resource
+ *  @copyright 	Prismal Studio 2008-2013 www.prismalstudio.com
+ */
+
+#ifndef TRESOURCEHANDLE_H_
+#define TRESOURCEHANDLE_H_
+
+namespace Util {
+
+template<typename T>
+class TResourceHandle {
+public:
+	TResourceHandle();
+	TResourceHandle(unsigned int index, unsigned int generation);
+
+	/**
+	 * @return true if the handle was never given by a manager
+	 */
+	bool isNull() const;
+
+	unsigned int getIndex() const;
+	unsigned int getGeneration() const;
+
+	bool operator==(const TResourceHandle<T>& h2) const;
+	bool operator!=(const TResourceHandle<T>& h2) const;
+
+private:
+	unsigned int mIndex; /**< slot index in the manager */
+	unsigned int mGeneration; /**< 0 is never used by a live slot */
+};
+
+template<typename T>
+inline TResourceHandle<T>::TResourceHandle() :
+		mIndex(0), mGeneration(0) {
+}
+
+template<typename T>
+inline TResourceHandle<T>::TResourceHandle(unsigned int index,
+		unsigned int generation) :
+		mIndex(index), mGeneration(generation) {
+}
+
+template<typename T>
+inline bool TResourceHandle<T>::isNull() const {
+	return mGeneration == 0;
+}
+
+template<typename T>
+inline unsigned int TResourceHandle<T>::getIndex() const {
+	return mIndex;
+}
+
+template<typename T>
+inline unsigned int TResourceHandle<T>::getGeneration() const {
+	return mGeneration;
+}
+
+template<typename T>
+inline bool TResourceHandle<T>::operator==(const TResourceHandle<T>& h2) const {
+	return (mIndex == h2.mIndex) && (mGeneration == h2.mGeneration);
+}
+
+template<typename T>
+inline bool TResourceHandle<T>::operator!=(const TResourceHandle<T>& h2) const {
+	return !(*this == h2);
+}
+
+} // namespace Util
+#endif /* TRESOURCEHANDLE_H_ */
@@ -14,6 +14,34 @@
  *  The file path serves as a key, if you use loadResource with a file
  *  that has already been loaded, you'll get the pointer to that resource.
  *
+ *  A memory budget can be set with setMemoryBudget(), the least recently
+ *  used resources that aren't pinned are then deleted to stay under it.
+ *  Don't keep a pointer to an unpinned resource when using a budget.
+ *
+ *  Prefer handles over raw pointers: acquire() returns a TResourceHandle
+ *  which get() turns into a pointer in O(1), or NULL once the resource
+ *  was deleted, evicted or unregistered. With setRefCounting(true),
+ *  an acquired resource isn't evicted until its handles are released.
+ *
+ *  reloadAll(ThreadPool&) loads fresh copies of the resources on the pool
+ *  and swaps their content in once every load is done, see
+ *  Resource::swapContent. The resources stay the same objects, with
+ *  their settings, so pointers and handles stay valid. Types that can't
+ *  swap are skipped. Nothing is locked, threads reading the resources
+ *  meanwhile must be synchronized by the caller.
+ *
+ *  Resources created by load() are allocated in slabs by a TObjectPool,
+ *  never delete them yourself. They can't be unregistered, as the caller
+ *  couldn't own them, unload() them instead. A resource given to
+ *  registerResource() belongs to the caller again once unregistered.
+ *
+ *  Load and reload durations, sizes and hit counts are recorded for each
+ *  resource, getStats() gives a copy of them. A load() hit only costs
+ *  two counter increments, the clock is read on misses and reloads.
+ *
+ *  With setCache(), load() and the reloads rebuild the resources from a
+ *  ResourceCache when their source didn't change, see Resource::serialize.
+ *
  *  CHANGES:
  *  	24-02-2013 EB useless if inside isLoaded
  *
@@ -27,9 +55,20 @@
 #define TManager_H_
 
 #include "Util/TSingleton.h"
+#include "Util/ThreadPool.h"
+#include "Util/TObjectPool.h"
+#include "TResourceHandle.h"
+#include "ResourceStats.h"
+#include "ResourceCache.h"
 //#include "Resource.h"
 
+#include <cassert>
 #include <map>
+#include <list>
+#include <vector>
+#include <chrono>
+#include <istream>
+#include <string>
 
 namespace Util {
 
@@ -45,15 +84,84 @@ public:
 	 */
 	T * load(const std::string& filename);
 
+	/**
+	 * Same as load, but the content comes from memory or a stream instead
+	 * of the file, e.g. from an archive. The cache isn't used and the
+	 * reloads skip these resources, the key isn't a file to read.
+	 * @param key is the key in the map of ressource, like a filename
+	 * @return a pointer to the resource itself or NULL if it failed
+	 */
+	T * loadFromMemory(const std::string& key, const char * data,
+			size_t size);
+	T * loadFromStream(const std::string& key, std::istream& stream);
+
+	/**
+	 * Same as load, but returns a handle to the resource.
+	 * When reference counting is on, the handle must be released.
+	 * @param filename is the key in the map of ressource
+	 * @return a handle to the resource, null if it failed
+	 */
+	TResourceHandle<T> acquire(const std::string& filename);
+
+	/**
+	 * Handle to an already loaded resource, doesn't count a reference.
+	 * @param filename is the key in the map of ressource
+	 * @return a null handle if the resource isn't loaded
+	 */
+	TResourceHandle<T> getHandle(const std::string& filename) const;
+
+	/**
+	 * O(1) access to the resource of a handle.
+	 * @param handle given by acquire or getHandle
+	 * @return the resource, or NULL if the handle is stale
+	 */
+	T * get(const TResourceHandle<T>& handle);
+
+	/**
+	 * @return true if the handle still points to a managed resource
+	 */
+	bool isValid(const TResourceHandle<T>& handle) const;
+
+	/**
+	 * Gives back a reference counted by acquire.
+	 * Does nothing if reference counting is off or the handle is stale.
+	 */
+	void release(const TResourceHandle<T>& handle);
+
+	/**
+	 * When on, acquire counts references and the memory budget
+	 * never evicts a resource that still has some. Off by default.
+	 */
+	void setRefCounting(bool enabled);
+	bool isRefCounting() const;
+
 	/**
 	 * Clear the map
 	 */
 	void deleteAll();
 
 	/**
-	 * Reload all the ressource in the map
+	 * Reload all the ressource in the map, with Resource::reload()
+	 * The ones loaded from memory or a stream are skipped.
+	 * @return the outcome of each resource
+	 */
+	std::vector<ResourceReloadResult> reloadAll();
+
+	/**
+	 * Load a new copy of every resource in parallel, then swap the
+	 * content of the ones which loaded successfully in the managed
+	 * resources, one after the other, in the calling thread. Resources
+	 * that failed keep their previous content. The managed resources
+	 * aren't touched until every load is done, so the calling thread
+	 * never sees a half-reloaded set; other threads must not use them
+	 * until it returns, nothing is locked.
+	 * A resource whose canSwapContent() is false isn't reloaded, its
+	 * result is marked skipped, use reloadAll() for them. The ones
+	 * loaded from memory or a stream are left out.
+	 * @param pool the worker threads to use
+	 * @return the outcome of each resource
 	 */
-	void reloadAll();
+	std::vector<ResourceReloadResult> reloadAll(ThreadPool& pool);
 
 	/**
 	 * Check if a file is already in the map
@@ -68,26 +176,173 @@ public:
 	 */
 	void registerResource(T * resource);
 	/**
-	 * Removes a texture from management
+	 * Removes a texture from management, the caller owns it again.
+	 * Only for a resource given to registerResource(), asserts on one
+	 * created by load() and leaves it managed, see unload().
 	 * @param resource of the sub-type to unregister
+	 * @return false if it wasn't unregistered
+	 */
+	bool unRegisterResource(T * resource);
+
+	/**
+	 * Delete a managed resource, however it was created, and invalidate
+	 * the handles to it.
+	 * @param filename key of the resource
+	 * @return false if the resource isn't loaded
 	 */
-	void unRegisterResource(T * resource);
+	bool unload(const std::string& filename);
 
 	/**
 	 * To get a string of all the keys (filename) in the map
 	 * @return a string of all keys on a line each
+	 * @deprecated getStats() has the keys and a lot more
 	 */
 	std::string listAllKey();
 
+	/**
+	 * Copy of the counters, the histograms and the figures
+	 * of every managed resource.
+	 */
+	ResourceManagerStats getStats() const;
+
+	/**
+	 * Set the maximum number of bytes the managed resources may use.
+	 * When exceeded, the least recently used unpinned resources are deleted.
+	 * @param bytes the budget, 0 means unlimited (default)
+	 */
+	void setMemoryBudget(size_t bytes);
+	size_t getMemoryBudget() const;
+
+	/**
+	 * @return the sum of getMemorySize() of all the managed resources
+	 */
+	size_t getMemoryUsage() const;
+
+	/**
+	 * A pinned resource is never evicted to respect the memory budget.
+	 * @param filename key of the resource
+	 * @return false if the resource isn't loaded
+	 */
+	bool pin(const std::string& filename);
+	bool unpin(const std::string& filename);
+	bool isPinned(const std::string& filename) const;
+
+	/**
+	 * Use an on-disk cache for load() and the reloads, the manager
+	 * doesn't own it. The managed resources are given it too.
+	 * @param cache NULL to load from the source files only (default)
+	 */
+	void setCache(ResourceCache * cache);
+	ResourceCache * getCache() const;
+
+	/**
+	 * Statistics counters
+	 */
+	unsigned long getHitCount() const; /**< load() found the resource */
+	unsigned long getMissCount() const; /**< load() had to load the file */
+	unsigned long getEvictCount() const; /**< deleted to fit the budget */
+
+	/**
+	 * Zero the counters and the histograms, including the ones
+	 * of each resource. Durations and sizes are kept.
+	 */
+	void resetCounters();
+
 protected:
 	TResourceManager();
 	virtual ~TResourceManager();
 private:
-	std::map<std::string, T *> mResourceMap; /**< the map in which all the resource are stored */
+
+	/**
+	 * Book keeping of a managed resource. Slots are reused, the
+	 * generation is incremented each time a slot is freed.
+	 */
+	struct Slot {
+		T * resource; /**< NULL when the slot is free */
+		unsigned int generation;
+		unsigned int refCount;
+		size_t size; /**< memory size as of the last (re)load */
+		bool pinned;
+		bool pooled; /**< allocated by mPool rather than the caller */
+		bool fromFile; /**< false if loaded from memory, can't be reloaded */
+		long long loadMicroseconds;
+		long long reloadMicroseconds; /**< of the last reload */
+		unsigned long reloadCount;
+		unsigned long reloadFailureCount;
+		unsigned long hitCount;
+		std::list<unsigned int>::iterator lruPos; /**< position in mLruList */
+	};
+
+	typedef std::map<std::string, unsigned int> IndexMap;
+
+	/**
+	 * Move the slot to the front of the LRU list
+	 */
+	void touch(Slot& slot);
+
+	/**
+	 * Shared by the load functions, loader(T&) fills a new resource
+	 * if the key isn't already loaded.
+	 * @param fromFile false if the key isn't the file loaded
+	 */
+	template<typename Loader>
+	T * loadWith(const std::string& filename, Loader loader, bool fromFile);
+
+	/**
+	 * Put the resource in a free slot, if its key isn't already used.
+	 * @return false if the key was already loaded
+	 */
+	bool addResource(T * resource, bool pooled);
+
+	/**
+	 * Load from the file, through the cache if there's one
+	 */
+	bool loadFile(T& resource, const std::string& filename) const;
+
+	/**
+	 * Update the size and the timings of a reloaded slot, or count
+	 * the failure
+	 */
+	void recordReload(Slot& slot, const ResourceReloadResult& result);
+
+	/**
+	 * Delete a resource the right way for the way it was allocated
+	 */
+	void destroyResource(T * resource, bool pooled);
+
+	/**
+	 * Forget the resource of a slot, without deleting it, and
+	 * invalidate the handles to it.
+	 */
+	void freeSlot(unsigned int index);
+
+	/**
+	 * Delete the least recently used unpinned resources until
+	 * the memory usage fits in the budget.
+	 * @param keep a resource that must not be evicted, can be NULL
+	 */
+	void evict(const T * keep);
+
+	TObjectPool<T> mPool; /**< storage for the resources created by load */
+	ResourceCache * mCache; /**< not owned, can be NULL */
+	IndexMap mResourceMap; /**< filename to slot index */
+	std::vector<Slot> mSlots; /**< dense storage indexed by the handles */
+	std::vector<unsigned int> mFreeSlots; /**< indices of the free slots */
+	std::list<unsigned int> mLruList; /**< slot indices, most recently used first */
+	bool mRefCounting;
+	size_t mMemoryBudget;
+	size_t mMemoryUsage;
+	unsigned long mHitCount;
+	unsigned long mMissCount;
+	unsigned long mEvictCount;
+	LatencyHistogram mLoadLatency;
+	LatencyHistogram mReloadLatency;
 };
 
 template<typename T>
-inline TResourceManager<T>::TResourceManager() {
+inline TResourceManager<T>::TResourceManager() :
+		mCache(NULL), mRefCounting(false), mMemoryBudget(0), mMemoryUsage(0), mHitCount(0), mMissCount(
+				0), mEvictCount(0) {
 }
 template<typename T>
 inline TResourceManager<T>::~TResourceManager() {
@@ -101,45 +356,255 @@ inline TResourceManager<T>::~TResourceManager() {
  */
 template<typename T>
 inline T * TResourceManager<T>::load(const std::string& filename) {
-	if (!isLoaded(filename)) {
-		T * newResource = new T();
+	return loadWith(filename, [this, &filename](T& resource) {
+		return loadFile(resource, filename);
+	}, true);
+}
+
+template<typename T>
+inline T * TResourceManager<T>::loadFromMemory(const std::string& key,
+		const char * data, size_t size) {
+	return loadWith(key, [data, size](T& resource) {
+		return resource.loadFromMemory(data, size);
+	}, false);
+}
+
+template<typename T>
+inline T * TResourceManager<T>::loadFromStream(const std::string& key,
+		std::istream& stream) {
+	return loadWith(key, [&stream](T& resource) {
+		return resource.loadFromStream(stream);
+	}, false);
+}
+
+template<typename T>
+template<typename Loader>
+inline T * TResourceManager<T>::loadWith(const std::string& filename,
+		Loader loader, bool fromFile) {
+	typename IndexMap::iterator pos = mResourceMap.find(filename);
+	if (pos == mResourceMap.end()) {
+		++mMissCount;
+		T * newResource = mPool.create();
 		newResource->setFilename(filename);
+		newResource->setCache(mCache);
 
 		// only register a loaded resource
 		// load return false on failed attempt
-		if (newResource->load(filename)) {
-			registerResource(newResource);
+		std::chrono::steady_clock::time_point start =
+				std::chrono::steady_clock::now();
+		bool loaded = loader(*newResource);
+		long long duration = microsecondsSince(start);
+		mLoadLatency.add(duration);
+
+		if (loaded) {
+			addResource(newResource, true);
+			Slot& slot = mSlots[mResourceMap[filename]];
+			slot.loadMicroseconds = duration;
+			slot.fromFile = fromFile;
 			return newResource;
 		}
+		mPool.destroy(newResource);
 	} else {
-		return mResourceMap[filename];
+		++mHitCount;
+		Slot& slot = mSlots[(*pos).second];
+		++slot.hitCount;
+		touch(slot);
+		return slot.resource;
 	}
 	return NULL;
 }
 
+template<typename T>
+inline TResourceHandle<T> TResourceManager<T>::acquire(
+		const std::string& filename) {
+	if (load(filename) == NULL) {
+		return TResourceHandle<T>();
+	}
+	TResourceHandle<T> handle = getHandle(filename);
+	if (mRefCounting) {
+		++mSlots[handle.getIndex()].refCount;
+	}
+	return handle;
+}
+
+template<typename T>
+inline TResourceHandle<T> TResourceManager<T>::getHandle(
+		const std::string& filename) const {
+	typename IndexMap::const_iterator pos = mResourceMap.find(filename);
+	if (pos == mResourceMap.end()) {
+		return TResourceHandle<T>();
+	}
+	return TResourceHandle<T>((*pos).second,
+			mSlots[(*pos).second].generation);
+}
+
+template<typename T>
+inline T * TResourceManager<T>::get(const TResourceHandle<T>& handle) {
+	if (!isValid(handle)) {
+		return NULL;
+	}
+	Slot& slot = mSlots[handle.getIndex()];
+	touch(slot);
+	return slot.resource;
+}
+
+template<typename T>
+inline bool TResourceManager<T>::isValid(
+		const TResourceHandle<T>& handle) const {
+	// a free slot never has the generation of a handle given while in use
+	return (handle.getIndex() < mSlots.size())
+			&& (mSlots[handle.getIndex()].generation == handle.getGeneration())
+			&& (mSlots[handle.getIndex()].resource != NULL);
+}
+
+template<typename T>
+inline void TResourceManager<T>::release(const TResourceHandle<T>& handle) {
+	if (mRefCounting && isValid(handle)) {
+		Slot& slot = mSlots[handle.getIndex()];
+		if (slot.refCount > 0) {
+			--slot.refCount;
+		}
+		if (slot.refCount == 0) {
+			evict(NULL);
+		}
+	}
+}
+
+template<typename T>
+inline void TResourceManager<T>::setRefCounting(bool enabled) {
+	mRefCounting = enabled;
+	if (!enabled) {
+		for (size_t i = 0; i < mSlots.size(); ++i) {
+			mSlots[i].refCount = 0;
+		}
+		evict(NULL);
+	}
+}
+
+template<typename T>
+inline bool TResourceManager<T>::isRefCounting() const {
+	return mRefCounting;
+}
+
 /**
  * Clear the map
  */
 template<typename T>
 inline void TResourceManager<T>::deleteAll() {
-	typename std::map<std::string, T*>::iterator pos = mResourceMap.begin();
+	typename IndexMap::iterator pos = mResourceMap.begin();
 	while (pos != mResourceMap.end()) {
-		delete (*pos).second;
+		unsigned int index = (*pos).second;
 		pos++;
+		T * resource = mSlots[index].resource;
+		bool pooled = mSlots[index].pooled;
+		freeSlot(index);
+		if (!pooled) {
+			delete resource;
+		}
 	}
-	mResourceMap.clear();
+	mMemoryUsage = 0;
+
+	// the pooled ones are released slab by slab
+	mPool.destroyAll();
 }
 
 /**
  * Reload all the ressource in the map
  */
 template<typename T>
-inline void TResourceManager<T>::reloadAll() {
-	typename std::map<std::string, T*>::iterator pos = mResourceMap.begin();
-	while (pos != mResourceMap.end()) {
-		(*pos).second->reload();
-		pos++;
+inline std::vector<ResourceReloadResult> TResourceManager<T>::reloadAll() {
+	std::vector<ResourceReloadResult> results;
+	results.reserve(mResourceMap.size());
+
+	// the slot array is contiguous, unlike the map
+	for (size_t i = 0; i < mSlots.size(); ++i) {
+		Slot& slot = mSlots[i];
+		if (slot.resource == NULL || !slot.fromFile) {
+			continue;
+		}
+		ResourceReloadResult result;
+		result.filename = slot.resource->getFilename();
+		result.skipped = false;
+
+		// a sub-class may reload safer than load(), e.g. LuaResource
+		std::chrono::steady_clock::time_point start =
+				std::chrono::steady_clock::now();
+		result.success = slot.resource->reload();
+		result.microseconds = microsecondsSince(start);
+
+		recordReload(slot, result);
+		results.push_back(result);
 	}
+	evict(NULL);
+	return results;
+}
+
+/**
+ * Load a new copy of every resource in parallel, then swap the content
+ * of the ones which loaded successfully in the managed resources.
+ * @param pool the worker threads to use
+ * @return the outcome of each resource
+ */
+template<typename T>
+inline std::vector<ResourceReloadResult> TResourceManager<T>::reloadAll(
+		ThreadPool& pool) {
+	std::vector<unsigned int> indices;
+	std::vector<T *> staging;
+	std::vector<ResourceReloadResult> results;
+
+	// allocate in this thread, only the loading is done in parallel
+	for (size_t i = 0; i < mSlots.size(); ++i) {
+		T * resource = mSlots[i].resource;
+		if (resource == NULL || !mSlots[i].fromFile) {
+			continue;
+		}
+		ResourceReloadResult result;
+		result.filename = resource->getFilename();
+		result.success = false;
+		result.skipped = !resource->canSwapContent();
+		result.microseconds = 0;
+		results.push_back(result);
+		indices.push_back(static_cast<unsigned int>(i));
+
+		// reloaded in place, it would be seen half done
+		if (result.skipped) {
+			staging.push_back(NULL);
+			continue;
+		}
+		T * newResource = mPool.create();
+		resource->copySettingsTo(*newResource);
+		staging.push_back(newResource);
+	}
+
+	// the managed resources aren't touched by the tasks
+	pool.parallelFor(staging.size(),
+			[this, &staging, &results](size_t i) {
+				if (staging[i] == NULL) {
+					return;
+				}
+				std::chrono::steady_clock::time_point start =
+						std::chrono::steady_clock::now();
+				results[i].success = loadFile(*staging[i],
+						results[i].filename);
+				results[i].microseconds = microsecondsSince(start);
+			});
+
+	// publish the staged content, nothing changed until now
+	for (size_t i = 0; i < staging.size(); ++i) {
+		if (staging[i] == NULL) {
+			continue;
+		}
+		Slot& slot = mSlots[indices[i]];
+		if (results[i].success) {
+			results[i].success = slot.resource->swapContent(*staging[i]);
+		}
+
+		// the staging resource holds the previous content now
+		mPool.destroy(staging[i]);
+		recordReload(slot, results[i]);
+	}
+	evict(NULL);
+	return results;
 }
 
 /**
@@ -158,18 +623,115 @@ inline bool TResourceManager<T>::isLoaded(std::string filename) {
  */
 template<typename T>
 inline void TResourceManager<T>::registerResource(T * resource) {
-	if (!isLoaded(resource->getFilename())) {
-		mResourceMap[resource->getFilename()] = resource;
-	}
+	addResource(resource, false);
 }
 /**
- * Removes a texture from management
+ * Removes a texture from management, the caller owns it again.
  * @param resource of the sub-type to unregister
+ * @return false if it wasn't unregistered
  */
 template<typename T>
-inline void TResourceManager<T>::unRegisterResource(T * resource) {
-	if (isLoaded(resource->getFilename())) {
-		mResourceMap.erase(resource->getFilename());
+inline bool TResourceManager<T>::unRegisterResource(T * resource) {
+	typename IndexMap::iterator pos = mResourceMap.find(
+			resource->getFilename());
+	if (pos == mResourceMap.end()
+			|| mSlots[(*pos).second].resource != resource) {
+		return false;
+	}
+
+	// a slab cell can't be handed over, the caller couldn't delete it
+	assert(!mSlots[(*pos).second].pooled && "unload() it instead");
+	if (mSlots[(*pos).second].pooled) {
+		return false;
+	}
+	mMemoryUsage -= mSlots[(*pos).second].size;
+	freeSlot((*pos).second);
+	resource->setCache(NULL);
+	return true;
+}
+
+template<typename T>
+inline bool TResourceManager<T>::unload(const std::string& filename) {
+	typename IndexMap::iterator pos = mResourceMap.find(filename);
+	if (pos == mResourceMap.end()) {
+		return false;
+	}
+	unsigned int index = (*pos).second;
+	T * resource = mSlots[index].resource;
+	bool pooled = mSlots[index].pooled;
+	mMemoryUsage -= mSlots[index].size;
+	freeSlot(index);
+	destroyResource(resource, pooled);
+	return true;
+}
+
+template<typename T>
+inline bool TResourceManager<T>::addResource(T * resource, bool pooled) {
+	if (!isLoaded(resource->getFilename())) {
+		unsigned int index;
+		if (mFreeSlots.empty()) {
+			index = static_cast<unsigned int>(mSlots.size());
+			Slot newSlot;
+			newSlot.resource = NULL;
+			newSlot.generation = 1;
+			mSlots.push_back(newSlot);
+		} else {
+			index = mFreeSlots.back();
+			mFreeSlots.pop_back();
+		}
+
+		Slot& slot = mSlots[index];
+		slot.resource = resource;
+		slot.refCount = 0;
+		slot.size = resource->getMemorySize();
+		slot.pinned = false;
+		slot.pooled = pooled;
+		slot.fromFile = true;
+		slot.loadMicroseconds = 0;
+		slot.reloadMicroseconds = 0;
+		slot.reloadCount = 0;
+		slot.reloadFailureCount = 0;
+		slot.hitCount = 0;
+		resource->setCache(mCache);
+		slot.lruPos = mLruList.insert(mLruList.begin(), index);
+
+		mResourceMap[resource->getFilename()] = index;
+		mMemoryUsage += slot.size;
+		evict(resource);
+		return true;
+	}
+	return false;
+}
+
+template<typename T>
+inline bool TResourceManager<T>::loadFile(T& resource,
+		const std::string& filename) const {
+	return mCache ? mCache->load(resource, filename) : resource.load(filename);
+}
+
+template<typename T>
+inline void TResourceManager<T>::recordReload(Slot& slot,
+		const ResourceReloadResult& result) {
+	mReloadLatency.add(result.microseconds);
+	if (!result.success) {
+		++slot.reloadFailureCount;
+		return;
+	}
+	slot.reloadMicroseconds = result.microseconds;
+	++slot.reloadCount;
+
+	// the size may have changed with the new content
+	mMemoryUsage -= slot.size;
+	slot.size = slot.resource->getMemorySize();
+	mMemoryUsage += slot.size;
+}
+
+template<typename T>
+inline void TResourceManager<T>::destroyResource(T * resource, bool pooled) {
+	if (pooled) {
+		mPool.destroy(resource);
+	} else {
+		delete resource;
 	}
 }
 
@@ -180,13 +742,180 @@ inline void TResourceManager<T>::unRegisterResource(T * resource) {
 template<typename T>
 inline std::string TResourceManager<T>::listAllKey() {
 	std::string listStr;
-	typename std::map<std::string, T*>::iterator pos = mResourceMap.begin();
-	while (pos != mResourceMap.end()) {
-		listStr += (*pos).first + "\n";
-		pos++;
+	for (size_t i = 0; i < mSlots.size(); ++i) {
+		if (mSlots[i].resource != NULL) {
+			listStr += mSlots[i].resource->getFilename() + "\n";
+		}
 	}
 	return listStr;
 }
 
+template<typename T>
+inline ResourceManagerStats TResourceManager<T>::getStats() const {
+	ResourceManagerStats stats;
+	stats.hitCount = mHitCount;
+	stats.missCount = mMissCount;
+	stats.evictCount = mEvictCount;
+	stats.memoryUsage = mMemoryUsage;
+	stats.memoryBudget = mMemoryBudget;
+	stats.loadLatency = mLoadLatency;
+	stats.reloadLatency = mReloadLatency;
+
+	stats.resources.reserve(mResourceMap.size());
+	for (size_t i = 0; i < mSlots.size(); ++i) {
+		const Slot& slot = mSlots[i];
+		if (slot.resource == NULL) {
+			continue;
+		}
+		ResourceStats resourceStats;
+		resourceStats.filename = slot.resource->getFilename();
+		resourceStats.bytes = slot.size;
+		resourceStats.loadMicroseconds = slot.loadMicroseconds;
+		resourceStats.reloadMicroseconds = slot.reloadMicroseconds;
+		resourceStats.reloadCount = slot.reloadCount;
+		resourceStats.reloadFailureCount = slot.reloadFailureCount;
+		resourceStats.hitCount = slot.hitCount;
+		resourceStats.pinned = slot.pinned;
+		resourceStats.refCount = slot.refCount;
+		stats.resources.push_back(resourceStats);
+	}
+	return stats;
+}
+
+template<typename T>
+inline void TResourceManager<T>::setMemoryBudget(size_t bytes) {
+	mMemoryBudget = bytes;
+	evict(NULL);
+}
+
+template<typename T>
+inline size_t TResourceManager<T>::getMemoryBudget() const {
+	return mMemoryBudget;
+}
+
+template<typename T>
+inline size_t TResourceManager<T>::getMemoryUsage() const {
+	return mMemoryUsage;
+}
+
+template<typename T>
+inline bool TResourceManager<T>::pin(const std::string& filename) {
+	typename IndexMap::iterator pos = mResourceMap.find(filename);
+	if (pos == mResourceMap.end()) {
+		return false;
+	}
+	mSlots[(*pos).second].pinned = true;
+	return true;
+}
+
+template<typename T>
+inline bool TResourceManager<T>::unpin(const std::string& filename) {
+	typename IndexMap::iterator pos = mResourceMap.find(filename);
+	if (pos == mResourceMap.end()) {
+		return false;
+	}
+	mSlots[(*pos).second].pinned = false;
+	evict(NULL);
+	return true;
+}
+
+template<typename T>
+inline bool TResourceManager<T>::isPinned(const std::string& filename) const {
+	typename IndexMap::const_iterator pos = mResourceMap.find(filename);
+	return (pos != mResourceMap.end()) && mSlots[(*pos).second].pinned;
+}
+
+template<typename T>
+inline void TResourceManager<T>::setCache(ResourceCache * cache) {
+	mCache = cache;
+	for (size_t i = 0; i < mSlots.size(); ++i) {
+		if (mSlots[i].resource != NULL) {
+			mSlots[i].resource->setCache(cache);
+		}
+	}
+}
+
+template<typename T>
+inline ResourceCache * TResourceManager<T>::getCache() const {
+	return mCache;
+}
+
+template<typename T>
+inline unsigned long TResourceManager<T>::getHitCount() const {
+	return mHitCount;
+}
+
+template<typename T>
+inline unsigned long TResourceManager<T>::getMissCount() const {
+	return mMissCount;
+}
+
+template<typename T>
+inline unsigned long TResourceManager<T>::getEvictCount() const {
+	return mEvictCount;
+}
+
+template<typename T>
+inline void TResourceManager<T>::resetCounters() {
+	mHitCount = 0;
+	mMissCount = 0;
+	mEvictCount = 0;
+	mLoadLatency.clear();
+	mReloadLatency.clear();
+	for (size_t i = 0; i < mSlots.size(); ++i) {
+		mSlots[i].hitCount = 0;
+		mSlots[i].reloadCount = 0;
+		mSlots[i].reloadFailureCount = 0;
+	}
+}
+
+template<typename T>
+inline void TResourceManager<T>::touch(Slot& slot) {
+	mLruList.splice(mLruList.begin(), mLruList, slot.lruPos);
+}
+
+template<typename T>
+inline void TResourceManager<T>::freeSlot(unsigned int index) {
+	Slot& slot = mSlots[index];
+	mResourceMap.erase(slot.resource->getFilename());
+	mLruList.erase(slot.lruPos);
+	slot.resource = NULL;
+	slot.refCount = 0;
+
+	// invalidate every handle, 0 is reserved for null handles
+	if (++slot.generation == 0) {
+		slot.generation = 1;
+	}
+	mFreeSlots.push_back(index);
+}
+
+template<typename T>
+inline void TResourceManager<T>::evict(const T * keep) {
+	if (mMemoryBudget == 0) {
+		return;
+	}
+
+	// walk from the least recently used
+	std::list<unsigned int>::iterator pos = mLruList.end();
+	while (mMemoryUsage > mMemoryBudget && pos != mLruList.begin()) {
+		--pos;
+		unsigned int index = *pos;
+		Slot& slot = mSlots[index];
+		if (slot.pinned || slot.refCount > 0 || slot.resource == keep) {
+			continue;
+		}
+
+		// freeSlot erases pos, step back to the next element which
+		// has already been visited
+		++pos;
+		T * resource = slot.resource;
+		bool pooled = slot.pooled;
+		mMemoryUsage -= slot.size;
+		freeSlot(index);
+		destroyResource(resource, pooled);
+		++mEvictCount;
+	}
+}
+
 } // namespace
 #endif /* TManager_H_ */
@@ -9,10 +9,38 @@
 #define TEXTRESOURCE_H_
 
 #include "Resource.h"
+#include "Util/MappedFile.h"
+#include "Util/TextView.h"
+#include "Util/TextSearch.h"
+#include "Util/TextPieceTable.h"
+
+#include <vector>
 
 namespace Util
 {
 
+/**
+ * Text file mapped in memory, it isn't copied in a std::string.
+ *
+ * The line index is built on the first line access, or with
+ * buildLineIndex(), after that every line access is O(1). Build it
+ * before sharing a resource between threads.
+ *
+ * Lines are separated by '\n', a '\r' before it is not part of the line.
+ * The views returned are valid until the resource is loaded again.
+ *
+ * With compression on, the text is kept as blocks of whole lines
+ * compressed independently (LZ4 block format) and the mapping is
+ * released. Line accesses decompress the block they need into a small
+ * cache of the calling thread, the views they return are then only
+ * valid until the same thread reads a few other blocks. getText() is
+ * empty in that mode, use copyText(). serialize() writes the compressed
+ * blocks, so a ResourceCache skips the compression on the next start.
+ *
+ * edit() gives a TextPieceTable over the text, the edits don't copy it
+ * and the unchanged parts keep pointing in the mapped file. The other
+ * accessors see the text as loaded until applyEdit().
+ */
 class TextResource: public Resource
 {
 	public:
@@ -26,10 +54,239 @@ class TextResource: public Resource
 		 */
 		virtual bool load(const std::string& filename);
 
+		/**
+		 * Copy the text from memory. With compression on, the blocks are
+		 * compressed straight from data and the text isn't copied.
+		 */
+		virtual bool loadFromMemory(const char * data, size_t size);
+
+		/**
+		 * Keep the text read from the stream, without copying it again.
+		 */
+		virtual bool loadFromStream(std::istream& stream);
+
+		virtual size_t getMemorySize() const;
+
+		/**
+		 * The filename, the compression and the block size
+		 */
+		virtual void copySettingsTo(Resource& staging) const;
+
+		/**
+		 * Take the text of another TextResource, an edit in progress is
+		 * cancelled. The views of the previous text go with it.
+		 */
+		virtual bool swapContent(Resource& staging);
+		virtual bool canSwapContent() const;
+
+		/**
+		 * Only a compressed text can be serialized
+		 */
+		virtual bool serialize(std::string& outData) const;
+		virtual bool canSerialize() const;
+
+		/**
+		 * Every block is decompressed once to check it. The text stays
+		 * compressed only if compression is on.
+		 */
+		virtual bool deserialize(const char * data, size_t size);
+
+		/**
+		 * Release the text and the line index.
+		 */
+		void close();
+
+		/**
+		 * Compression used by the resources created afterwards, e.g. by a
+		 * TResourceManager. Off by default.
+		 * @param blockSize uncompressed size of a block, lines aren't split
+		 */
+		static void setCompressionByDefault(bool enabled,
+				size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+		/**
+		 * Turn compression on or off, the current text is converted.
+		 * @param blockSize uncompressed size of a block, lines aren't split
+		 */
+		void setCompression(bool enabled, size_t blockSize = DEFAULT_BLOCK_SIZE);
+		bool isCompressed() const;
+
+		/**
+		 * @return the size of the compressed blocks, 0 if not compressed
+		 */
+		size_t getCompressedSize() const;
+
+		/**
+		 * @return the whole text, empty when compressed
+		 */
+		TextView getText() const;
+		size_t getSize() const;
+
+		/**
+		 * Copy the whole text, works in both modes.
+		 */
+		void copyText(std::string& outText) const;
+
+		/**
+		 * Scan the text for the line breaks, if not already done.
+		 */
+		void buildLineIndex() const;
+		bool isLineIndexBuilt() const;
+
+		size_t getLineCount() const;
+
+		/**
+		 * @param line starting at 0
+		 * @return the line without its line break, empty if out of range
+		 */
+		TextView getLine(size_t line) const;
+
+		/**
+		 * @param first line of the range
+		 * @param count number of lines
+		 * @return the lines and the line breaks between them
+		 */
+		TextView getLines(size_t first, size_t count) const;
+
+		/**
+		 * @return the offset of the first character of a line,
+		 * getSize() if out of range.
+		 */
+		size_t getLineOffset(size_t line) const;
+
+		/**
+		 * @return the line holding the character at offset, O(log n)
+		 */
+		size_t getLineOfOffset(size_t offset) const;
+
+		/**
+		 * Append every occurrence of a pattern, with its line.
+		 * @return the number of matches added
+		 */
+		size_t find(TextView pattern, std::vector<TextMatch>& outMatches) const;
+
+		/**
+		 * Append every occurrence of every pattern of a built set, with
+		 * their line, in a single pass over the text.
+		 * @return the number of matches added
+		 */
+		size_t find(const TextPatternSet& patterns,
+				std::vector<TextMatch>& outMatches) const;
+
+		/**
+		 * Start editing the text, or continue the current edit. A
+		 * compressed text is decompressed first.
+		 * @return the edited text, valid until applyEdit(), cancelEdit(),
+		 * setCompression() or the next load.
+		 */
+		TextPieceTable& edit();
+		bool isEditing() const;
+
+		/**
+		 * Replace the text by the edited one, it is copied once and
+		 * compressed again if compression is on.
+		 */
+		void applyEdit();
+
+		/**
+		 * Drop the edited text and its history.
+		 */
+		void cancelEdit();
+
+		static const size_t DEFAULT_BLOCK_SIZE = 16 * 1024;
+
 	private:
-		std::string mFileText;
+		/**
+		 * A compressed range of whole lines
+		 */
+		struct Block
+		{
+			size_t offset; /**< in the uncompressed text */
+			size_t size; /**< uncompressed */
+			size_t firstLine;
+			size_t compressedOffset; /**< in mCompressedData */
+			size_t compressedSize;
+		};
+
+		/**
+		 * A decompressed block in the cache of a thread, defined in the .cpp
+		 */
+		struct CachedBlock;
+
+		/**
+		 * Fill the line of the matches from first to the end
+		 */
+		void setMatchLines(std::vector<TextMatch>& matches, size_t first) const;
+
+		/**
+		 * Offset just past the last character of a line, before '\r\n'
+		 */
+		size_t getLineEnd(size_t line) const;
+
+		/**
+		 * Replace the text by compressed blocks
+		 */
+		void compress();
+
+		/**
+		 * Replace the content by the compressed blocks of text, which is
+		 * only read before the content is released
+		 */
+		void compress(const char * text, size_t textSize);
+
+		/**
+		 * Replace the compressed blocks by the text
+		 */
+		void decompress();
+
+		/**
+		 * Replace the content by text, which is emptied, compressed
+		 * if compression is on
+		 */
+		void takeText(std::string& text);
+
+		size_t findBlockOfLine(size_t line) const;
+		size_t findBlockOfOffset(size_t offset) const;
+
+		/**
+		 * Decompress a block in the cache of the calling thread
+		 */
+		const CachedBlock& getCachedBlock(size_t block) const;
+
+		/**
+		 * Decompress a block in out, which must have room for it
+		 * @return false if the block is corrupted, out is then zeroed
+		 */
+		bool decompressBlock(size_t block, char * out) const;
+
+		/**
+		 * Check that the blocks cover the text in order, decompress and
+		 * hold the lines the table says, for a table read from a file
+		 */
+		bool checkBlocks() const;
+
+		MappedFile mMappedFile; /**< when loaded from a file */
+		std::string mOwnedText; /**< when loaded from memory */
+		const char * mText; /**< points in one of the above */
+		size_t mSize;
+
+		mutable std::vector<size_t> mLineStarts; /**< offset of each line */
+		mutable bool mLineIndexBuilt;
+
+		bool mCompression; /**< compress the text when loaded */
+		size_t mBlockSize;
+		bool mCompressed; /**< the text is in mBlocks, mText is NULL */
+		std::vector<Block> mBlocks;
+		std::string mCompressedData;
+		size_t mLineCount; /**< when compressed */
+		unsigned long mContentId; /**< identifies the blocks in the caches */
+
+		TextPieceTable * mEdit; /**< NULL when not editing */
+
+		static bool sCompressionByDefault;
+		static size_t sDefaultBlockSize;
 };
 
-} /* namespace xover */
+} /* namespace Util */
 
 #endif /* TEXTRESOURCE_H_ */
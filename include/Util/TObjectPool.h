@@ -0,0 +1,257 @@
+/**
+ *  @file		TObjectPool.h
+ *  @brief     	Allocates objects of a single type from contiguous slabs.
+ *  @details	Objects are constructed in place in big blocks (slabs) of
+ *  			memory instead of one heap allocation each. Destroyed objects
+ *  			leave a hole that the next create() reuses.
+ *
+ *  			TObjectPool<Foo> pool;
+ *  			Foo * foo = pool.create();
+ *  			[...]
+ *  			pool.destroy(foo); // or pool.destroyAll();
+ *
+ *  			destroyAll() runs the destructors slab by slab and then
+ *  			releases each slab with a single deallocation.
+ *
+ *  @date      	2026-10-19
+ *  @pre		T must be default constructible
+ *  @copyright 	Prismal Studio 2008-2013 www.prismalstudio.com
+ */
+
+#ifndef TOBJECTPOOL_H_
+#define TOBJECTPOOL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <vector>
+
+namespace Util
+{
+
+template<typename T>
+class TObjectPool
+{
+	public:
+		/**
+		 * @param objectsPerSlab number of objects in each slab
+		 */
+		explicit TObjectPool(size_t objectsPerSlab = 64);
+		~TObjectPool();
+
+		/**
+		 * Default construct a new object in the pool.
+		 * @return the new object
+		 */
+		T * create();
+
+		/**
+		 * Destruct an object created by this pool.
+		 * @param object NULL is ignored
+		 */
+		void destroy(T * object);
+
+		/**
+		 * Destruct every object and release all the slabs.
+		 */
+		void destroyAll();
+
+		/**
+		 * @return true if the object lives in one of the slabs
+		 */
+		bool owns(const T * object) const;
+
+		/**
+		 * @return the number of live objects
+		 */
+		size_t size() const;
+
+		/**
+		 * Call func(T&) on each live object, in memory order.
+		 */
+		template<typename Func>
+		void forEach(Func func);
+
+	private:
+		TObjectPool(const TObjectPool&);
+		TObjectPool& operator=(const TObjectPool&);
+
+		struct Slab
+		{
+			T * objects; /**< raw storage for mObjectsPerSlab objects */
+			std::vector<bool> alive;
+		};
+
+		/**
+		 * Start of a slab, mSlabStarts is sorted by address
+		 */
+		struct SlabStart
+		{
+			const T * objects;
+			size_t slab; /**< index in mSlabs */
+		};
+
+		/**
+		 * Orders the slab starts, std::less is a total order on pointers
+		 */
+		static bool startsBefore(const T * object, const SlabStart& start);
+
+		/**
+		 * Index of the slab that holds the object, mSlabs.size() if none.
+		 * O(log slabs).
+		 */
+		size_t findSlab(const T * object) const;
+
+		std::vector<Slab> mSlabs;
+		std::vector<SlabStart> mSlabStarts;
+		std::vector<T *> mFreeList; /**< unused cells of the slabs */
+		size_t mObjectsPerSlab;
+		size_t mSize;
+};
+
+template<typename T>
+inline TObjectPool<T>::TObjectPool(size_t objectsPerSlab) :
+				mObjectsPerSlab(objectsPerSlab > 0 ? objectsPerSlab : 1),
+				mSize(0)
+{
+}
+
+template<typename T>
+inline TObjectPool<T>::~TObjectPool()
+{
+	destroyAll();
+}
+
+template<typename T>
+inline T * TObjectPool<T>::create()
+{
+	if (mFreeList.empty())
+	{
+		Slab slab;
+		slab.objects = static_cast<T *>(::operator new(
+				sizeof(T) * mObjectsPerSlab));
+		slab.alive.resize(mObjectsPerSlab, false);
+		mSlabs.push_back(slab);
+
+		SlabStart start;
+		start.objects = slab.objects;
+		start.slab = mSlabs.size() - 1;
+		mSlabStarts.insert(std::upper_bound(mSlabStarts.begin(),
+				mSlabStarts.end(), start.objects, startsBefore), start);
+
+		// reversed so the objects are handed out in memory order
+		for (size_t i = mObjectsPerSlab; i > 0; --i)
+		{
+			mFreeList.push_back(slab.objects + i - 1);
+		}
+	}
+
+	T * cell = mFreeList.back();
+	T * object = new (cell) T();
+
+	// only taken once the constructor didn't throw
+	mFreeList.pop_back();
+	size_t slabIndex = findSlab(object);
+	mSlabs[slabIndex].alive[object - mSlabs[slabIndex].objects] = true;
+	++mSize;
+	return object;
+}
+
+template<typename T>
+inline void TObjectPool<T>::destroy(T * object)
+{
+	if (object == NULL)
+	{
+		return;
+	}
+	size_t slabIndex = findSlab(object);
+	if (slabIndex == mSlabs.size())
+	{
+		return; // not from this pool
+	}
+
+	object->~T();
+	mSlabs[slabIndex].alive[object - mSlabs[slabIndex].objects] = false;
+	mFreeList.push_back(object);
+	--mSize;
+}
+
+template<typename T>
+inline void TObjectPool<T>::destroyAll()
+{
+	for (size_t s = 0; s < mSlabs.size(); ++s)
+	{
+		Slab& slab = mSlabs[s];
+		for (size_t i = 0; i < mObjectsPerSlab; ++i)
+		{
+			if (slab.alive[i])
+			{
+				slab.objects[i].~T();
+			}
+		}
+		::operator delete(slab.objects);
+	}
+	mSlabs.clear();
+	mSlabStarts.clear();
+	mFreeList.clear();
+	mSize = 0;
+}
+
+template<typename T>
+inline bool TObjectPool<T>::owns(const T * object) const
+{
+	return findSlab(object) != mSlabs.size();
+}
+
+template<typename T>
+inline size_t TObjectPool<T>::size() const
+{
+	return mSize;
+}
+
+template<typename T>
+template<typename Func>
+inline void TObjectPool<T>::forEach(Func func)
+{
+	for (size_t s = 0; s < mSlabs.size(); ++s)
+	{
+		Slab& slab = mSlabs[s];
+		for (size_t i = 0; i < mObjectsPerSlab; ++i)
+		{
+			if (slab.alive[i])
+			{
+				func(slab.objects[i]);
+			}
+		}
+	}
+}
+
+template<typename T>
+inline bool TObjectPool<T>::startsBefore(const T * object,
+		const SlabStart& start)
+{
+	return std::less<const T *>()(object, start.objects);
+}
+
+template<typename T>
+inline size_t TObjectPool<T>::findSlab(const T * object) const
+{
+	// the last slab starting at or before the object
+	typename std::vector<SlabStart>::const_iterator pos = std::upper_bound(
+			mSlabStarts.begin(), mSlabStarts.end(), object, startsBefore);
+	if (pos == mSlabStarts.begin())
+	{
+		return mSlabs.size();
+	}
+	--pos;
+	if (std::less<const T *>()(object, (*pos).objects + mObjectsPerSlab))
+	{
+		return (*pos).slab;
+	}
+	return mSlabs.size();
+}
+
+} // namespace Util
+
+#endif /* TOBJECTPOOL_H_ */
@@ -26,6 +26,7 @@ template<typename T>
 class TRectangle {
 public:
 	TRectangle(T x = 0, T y = 0, T w = 0, T h = 0);
+	TRectangle(const TRectangle& r2);
 	~TRectangle(void) {
 	}
 
@@ -95,6 +96,17 @@ inline TRectangle<T>::TRectangle(T x, T y, T w, T h) {
 	this->h = h;
 }
 
+//-----------------------------------------------------------------------------
+// Purpose: Copy constructor, declared along operator=
+//-----------------------------------------------------------------------------
+template<typename T>
+inline TRectangle<T>::TRectangle(const TRectangle& r2) {
+	x = r2.x;
+	y = r2.y;
+	w = r2.w;
+	h = r2.h;
+}
+
 //-----------------------------------------------------------------------------
 // Purpose: Check if TRectangle contains a 2D vector
 //-----------------------------------------------------------------------------
@@ -114,7 +126,7 @@ inline bool TRectangle<T>::contains(TVector2<T>& vVec) const {
 template<typename T>
 inline bool TRectangle<T>::contains(T x, T y) const {
 	if ((x >= this->x) && (x <= this->x + this->w) && (y >= this->y)
-			&& (x <= this->y + this->h)) {
+			&& (y <= this->y + this->h)) {
 		return true;
 	} else
 		return false;
@@ -0,0 +1,279 @@
+/**
+ *  @file		TRotation2.h
+ *  @brief     	2D rotation keeping its sine and cosine.
+ *  @details	TVector2::rotate() computes the sine and cosine of the angle
+ *  			on each call. A TRotation2 computes them once, rotating a
+ *  			vector is then 4 multiplications and 2 additions.
+ *
+ *  			TRotation2<float> rotation = TRotation2<float>::fromDegrees(30);
+ *  			rotation.rotate(positions); // a TVector2Array, vectorized
+ *  			TVector2<float> v = rotation.rotate(TVector2<float>(1, 0));
+ *
+ *  			fastSinCos() is a polynomial approximation for the angles
+ *  			changing every frame, e.g. one per bone or per sprite.
+ *
+ *  @date      	2026-10-19
+ *  @copyright 	Prismal Studio 2008-2013 www.prismalstudio.com
+ */
+
+#ifndef TROTATION2_H_
+#define TROTATION2_H_
+
+#include "Util/TVector2.h"
+#include "Util/TVector2Array.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Util
+{
+
+/**
+ * Sine and cosine together, without calling sinf() and cosf(). The angle
+ * is brought back in [-pi/4, pi/4] with pi/2 split in three constants,
+ * then degree 7 and 8 polynomials (the Cephes ones) are used. No table
+ * and no branch, a loop over it is vectorized by the compiler with -O3.
+ *
+ * Largest absolute error measured against the double precision sin()
+ * and cos(), on 4 million angles evenly spread, checked by
+ * test/TRotation2Test.cpp:
+ * |radians| <= 1000 pi:  9.3e-8 (sinf() and cosf(): 3.3e-8)
+ * |radians| <= 10000 pi: 4.9e-7
+ * |radians| <= 102943:   9.7e-7
+ * Past 2^16 pi / 2 (102943), k * PI_OVER_2_HIGH isn't exact anymore and
+ * the error grows like the spacing of the floats around the angle:
+ * |radians| <= 1e6:      3.2e-2
+ * |radians| <= 1.3e7:    0.5
+ * The angle must be below 2^23 pi / 2 (1.3e7) in absolute value. Beyond,
+ * the results are meaningless, huge values, infinities or NaNs, but the
+ * quadrant is clamped so its conversion to int stays defined. A NaN
+ * gives NaNs.
+ *
+ * The loop of the array overload is about 3 times faster than sinf()
+ * and cosf() with -O3 (5 times with AVX2), one call alone barely is.
+ */
+inline void fastSinCos(float radians, float& outSin, float& outCos)
+{
+	const float TWO_OVER_PI = 0.636619772367581343f;
+	const float PI_OVER_2_HIGH = 1.5703125f;
+	const float PI_OVER_2_MID = 4.83751296997070312e-4f;
+	const float PI_OVER_2_LOW = 7.54978995489188216e-8f;
+
+	const float MAX_QUADRANT = 8388608.0f; // 2^23, fits an int exactly
+
+	// quadrant of the angle, rounded to nearest. Clamped so the
+	// conversion is defined, std::max() turns a NaN into -MAX_QUADRANT
+	float scaled = radians * TWO_OVER_PI;
+	scaled = std::max(-MAX_QUADRANT, std::min(scaled, MAX_QUADRANT));
+	int quadrant = static_cast<int>(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+	float k = static_cast<float>(quadrant);
+	float r = ((radians - k * PI_OVER_2_HIGH) - k * PI_OVER_2_MID)
+			- k * PI_OVER_2_LOW;
+
+	float z = r * r;
+	float s = r + r * z * (-1.6666654611e-1f
+			+ z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+	float c = 1.0f - 0.5f * z + z * z * (4.166664568298827e-2f
+			+ z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+
+	// sin(r + k pi/2) and cos(r + k pi/2)
+	float quadrantSin = (quadrant & 1) ? c : s;
+	float quadrantCos = (quadrant & 1) ? s : c;
+	outSin = (quadrant & 2) ? -quadrantSin : quadrantSin;
+	outCos = ((quadrant + 1) & 2) ? -quadrantCos : quadrantCos;
+}
+
+/**
+ * fastSinCos() of each angle
+ */
+inline void fastSinCos(const float * radians, float * outSin, float * outCos,
+		size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		float sinAngle;
+		float cosAngle;
+		fastSinCos(radians[i], sinAngle, cosAngle);
+		outSin[i] = sinAngle;
+		outCos[i] = cosAngle;
+	}
+}
+
+template<typename T>
+class TRotation2
+{
+	public:
+		/**
+		 * No rotation
+		 */
+		TRotation2();
+
+		/**
+		 * @param radians counterclockwise, like TVector2::rotateRadians()
+		 */
+		explicit TRotation2(T radians);
+
+		static TRotation2<T> fromDegrees(T degrees);
+
+		/**
+		 * With fastSinCos(), see its error bounds
+		 */
+		static TRotation2<T> fromRadiansFast(T radians);
+
+		/**
+		 * @param direction the rotation from (1, 0) to it, must not be
+		 * (0, 0)
+		 */
+		static TRotation2<T> fromDirection(const TVector2<T>& direction);
+
+		void setRadians(T radians);
+
+		/**
+		 * @return the angle in ]-pi, pi]
+		 */
+		T getRadians() const;
+		T getSin() const;
+		T getCos() const;
+
+		TVector2<T> rotate(const TVector2<T>& vector) const;
+
+		/**
+		 * Rotate count vectors, in may be out
+		 */
+		void rotate(const TVector2<T> * in, TVector2<T> * out,
+				size_t count) const;
+
+		/**
+		 * Rotate every vector of the array, vectorized for floats
+		 */
+		void rotate(TVector2Array<T>& array) const;
+
+		/**
+		 * The rotation back
+		 */
+		TRotation2<T> inverse() const;
+
+		/**
+		 * This rotation after other, the angles add up
+		 */
+		TRotation2<T> operator*(const TRotation2<T>& other) const;
+
+	private:
+		T mSin;
+		T mCos;
+};
+
+template<typename T>
+inline TRotation2<T>::TRotation2() :
+				mSin(0),
+				mCos(1)
+{
+}
+
+template<typename T>
+inline TRotation2<T>::TRotation2(T radians)
+{
+	setRadians(radians);
+}
+
+template<typename T>
+inline TRotation2<T> TRotation2<T>::fromDegrees(T degrees)
+{
+	return TRotation2<T>(static_cast<T>(degrees * M_PI / 180));
+}
+
+template<typename T>
+inline TRotation2<T> TRotation2<T>::fromRadiansFast(T radians)
+{
+	float sinAngle;
+	float cosAngle;
+	fastSinCos(static_cast<float>(radians), sinAngle, cosAngle);
+
+	TRotation2<T> rotation;
+	rotation.mSin = static_cast<T>(sinAngle);
+	rotation.mCos = static_cast<T>(cosAngle);
+	return rotation;
+}
+
+template<typename T>
+inline TRotation2<T> TRotation2<T>::fromDirection(const TVector2<T>& direction)
+{
+	TVector2<T> unit(direction);
+	unit.normalize();
+
+	TRotation2<T> rotation;
+	rotation.mSin = unit.getY();
+	rotation.mCos = unit.getX();
+	return rotation;
+}
+
+template<typename T>
+inline void TRotation2<T>::setRadians(T radians)
+{
+	mSin = static_cast<T>(sin(radians));
+	mCos = static_cast<T>(cos(radians));
+}
+
+template<typename T>
+inline T TRotation2<T>::getRadians() const
+{
+	return static_cast<T>(atan2(mSin, mCos));
+}
+
+template<typename T>
+inline T TRotation2<T>::getSin() const
+{
+	return mSin;
+}
+
+template<typename T>
+inline T TRotation2<T>::getCos() const
+{
+	return mCos;
+}
+
+template<typename T>
+inline TVector2<T> TRotation2<T>::rotate(const TVector2<T>& vector) const
+{
+	return TVector2<T>(vector.getX() * mCos - vector.getY() * mSin,
+			vector.getY() * mCos + vector.getX() * mSin);
+}
+
+template<typename T>
+inline void TRotation2<T>::rotate(const TVector2<T> * in, TVector2<T> * out,
+		size_t count) const
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = rotate(in[i]);
+	}
+}
+
+template<typename T>
+inline void TRotation2<T>::rotate(TVector2Array<T>& array) const
+{
+	rotateVectors(array.getX(), array.getY(), mCos, mSin, array.size());
+}
+
+template<typename T>
+inline TRotation2<T> TRotation2<T>::inverse() const
+{
+	TRotation2<T> rotation;
+	rotation.mSin = -mSin;
+	rotation.mCos = mCos;
+	return rotation;
+}
+
+template<typename T>
+inline TRotation2<T> TRotation2<T>::operator*(const TRotation2<T>& other) const
+{
+	// sin(a + b) and cos(a + b)
+	TRotation2<T> rotation;
+	rotation.mSin = mSin * other.mCos + mCos * other.mSin;
+	rotation.mCos = mCos * other.mCos - mSin * other.mSin;
+	return rotation;
+}
+
+} /* namespace Util */
+
+#endif /* TROTATION2_H_ */
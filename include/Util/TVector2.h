@@ -25,11 +25,13 @@ class TVector2 {
 
 public:
 	TVector2(T x = 0, T y = 0);
+	TVector2(const TVector2<T>& v2);
 	~TVector2() {
 	}
 
 	// Useful methods
 	TVector2<T> rotate(const float& angle) const;
+	TVector2<T> rotateRadians(const float& angle) const;
 	TVector2<T> scale(const float& scalar) const;
 	float magnitude() const;
 	float normalize();
@@ -85,6 +87,15 @@ inline TVector2<T>::TVector2(T x, T y) {
 	this->y = y;
 }
 
+//-----------------------------------------------------------------------------
+// Purpose: Copy constructor, declared along operator=
+//-----------------------------------------------------------------------------
+template<typename T>
+inline TVector2<T>::TVector2(const TVector2<T>& v2) {
+	x = v2.x;
+	y = v2.y;
+}
+
 /**
  * rotate a vector
  * @param angle an angle in degrees
@@ -93,11 +104,20 @@ inline TVector2<T>::TVector2(T x, T y) {
 template<typename T>
 inline TVector2<T> TVector2<T>::rotate(const float& angle) const {
 	// in degrees
-	float xt = (x * cosf(angle * M_PI / 180)) - (y * sinf(angle * M_PI / 180));
-	float yt = (y * cosf(angle * M_PI / 180)) + (x * sinf(angle * M_PI / 180));
-	// uncomment to have it in radians
-//	float xt = (x * cosf(angle)) - (y * sinf(angle));
-//	float yt = (y * cosf(angle)) + (x * sinf(angle));
+	return rotateRadians(angle * M_PI / 180);
+}
+
+/**
+ * rotate a vector, see TRotation2 to rotate many vectors by the same angle
+ * @param angle an angle in radians
+ * @return a new TVector2
+ */
+template<typename T>
+inline TVector2<T> TVector2<T>::rotateRadians(const float& angle) const {
+	float c = cosf(angle);
+	float s = sinf(angle);
+	float xt = (x * c) - (y * s);
+	float yt = (y * c) + (x * s);
 	return TVector2<T>(xt, yt);
 }
 
@@ -0,0 +1,555 @@
+/**
+ *  @file		TVector2Array.h
+ *  @brief     	Structure of arrays of 2D vectors, with batch operations.
+ *  @details	The x and the y of the vectors are in two separate arrays,
+ *  			aligned on 32 bytes, so an operation over the whole array
+ *  			runs 4 or 8 vectors at a time (SSE, or AVX when compiled
+ *  			with it) for floats.
+ *
+ *  			TVector2Array<float> positions;
+ *  			positions.assign(vectors); // from a std::vector<TVector2f>
+ *  			positions.add(velocities);
+ *  			positions.copyTo(vectors);
+ *
+ *  			No approximation is used, the square roots and divisions
+ *  			are the exact ones: the results are those of the TVector2
+ *  			methods, up to the rounding of distance() which TVector2
+ *  			computes in double.
+ *
+ *  @date      	2026-10-19
+ *  @pre		T must be an arithmetic type
+ *  @copyright 	Prismal Studio 2008-2013 www.prismalstudio.com
+ */
+
+#ifndef TVECTOR2ARRAY_H_
+#define TVECTOR2ARRAY_H_
+
+#include "Util/TVector2.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace Util
+{
+
+/*
+ * Kernels over separate x and y arrays, for any T. The float ones,
+ * below, are vectorized.
+ */
+
+template<typename T>
+void addVectors(T * x, T * y, const T * otherX, const T * otherY,
+		size_t count);
+
+template<typename T>
+void translateVectors(T * x, T * y, T dx, T dy, size_t count);
+
+template<typename T>
+void scaleVectors(T * x, T * y, T scalar, size_t count);
+
+template<typename T>
+void dotVectors(const T * x, const T * y, const T * otherX, const T * otherY,
+		T * out, size_t count);
+
+template<typename T>
+void normalizeVectors(T * x, T * y, size_t count);
+
+template<typename T>
+void rotateVectors(T * x, T * y, T cosAngle, T sinAngle, size_t count);
+
+template<typename T>
+void distanceVectors(const T * x, const T * y, const T * otherX,
+		const T * otherY, T * out, size_t count);
+
+/**
+ * x0 y0 x1 y1... to separate arrays, and back
+ */
+template<typename T>
+void splitVectors(const TVector2<T> * vectors, T * x, T * y, size_t count);
+
+template<typename T>
+void joinVectors(const T * x, const T * y, TVector2<T> * vectors,
+		size_t count);
+
+void addVectors(float * x, float * y, const float * otherX,
+		const float * otherY, size_t count);
+void translateVectors(float * x, float * y, float dx, float dy, size_t count);
+void scaleVectors(float * x, float * y, float scalar, size_t count);
+void dotVectors(const float * x, const float * y, const float * otherX,
+		const float * otherY, float * out, size_t count);
+void normalizeVectors(float * x, float * y, size_t count);
+void rotateVectors(float * x, float * y, float cosAngle, float sinAngle,
+		size_t count);
+void distanceVectors(const float * x, const float * y, const float * otherX,
+		const float * otherY, float * out, size_t count);
+void splitVectors(const TVector2<float> * vectors, float * x, float * y,
+		size_t count);
+void joinVectors(const float * x, const float * y, TVector2<float> * vectors,
+		size_t count);
+
+template<typename T>
+class TVector2Array
+{
+	public:
+		TVector2Array();
+		explicit TVector2Array(size_t size);
+		TVector2Array(const TVector2Array<T>& array);
+		TVector2Array<T>& operator=(const TVector2Array<T>& array);
+		~TVector2Array();
+
+		size_t size() const;
+		bool empty() const;
+
+		/**
+		 * The new vectors are (0, 0)
+		 */
+		void resize(size_t size);
+		void reserve(size_t capacity);
+		void clear();
+
+		void append(const TVector2<T>& vector);
+		TVector2<T> get(size_t index) const;
+		void set(size_t index, const TVector2<T>& vector);
+
+		/**
+		 * The coordinates, aligned on ALIGNMENT, valid until the array
+		 * grows.
+		 */
+		T * getX();
+		T * getY();
+		const T * getX() const;
+		const T * getY() const;
+
+		/**
+		 * Replace the content by an array of TVector2
+		 */
+		void assign(const TVector2<T> * vectors, size_t count);
+		void assign(const std::vector<TVector2<T> >& vectors);
+
+		/**
+		 * Write the content as TVector2, outVectors is resized
+		 */
+		void copyTo(TVector2<T> * outVectors) const;
+		void copyTo(std::vector<TVector2<T> >& outVectors) const;
+
+		/**
+		 * Each vector += the one at the same index of other, the sizes
+		 * must be the same.
+		 */
+		void add(const TVector2Array<T>& other);
+
+		/**
+		 * Each vector += offset
+		 */
+		void add(const TVector2<T>& offset);
+
+		void scale(T scalar);
+
+		/**
+		 * Like TVector2::normalize(), the (0, 0) vectors stay as they are.
+		 */
+		void normalize();
+
+		/**
+		 * @param angle in degrees, like TVector2::rotate()
+		 */
+		void rotate(float angle);
+
+		/**
+		 * @param out receives size() dot products with the vectors of other,
+		 * which must have the same size
+		 */
+		void dot(const TVector2Array<T>& other, T * out) const;
+
+		/**
+		 * @param out receives size() distances to the vectors of other,
+		 * which must have the same size
+		 */
+		void distance(const TVector2Array<T>& other, T * out) const;
+
+		/**
+		 * In bytes, of the start of x and y
+		 */
+		static const size_t ALIGNMENT = 32;
+
+	private:
+		/**
+		 * Move to a buffer of capacity vectors, keeping the content
+		 */
+		void reallocate(size_t capacity);
+
+		char * mBuffer; /**< allocated, mX points in it */
+		T * mX; /**< mCapacity x then mCapacity y */
+		T * mY;
+		size_t mSize;
+		size_t mCapacity; /**< a multiple of ALIGNMENT / sizeof(T) */
+};
+
+/*
+ * Generic kernels
+ */
+
+template<typename T>
+inline void addVectors(T * x, T * y, const T * otherX, const T * otherY,
+		size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] += otherX[i];
+		y[i] += otherY[i];
+	}
+}
+
+template<typename T>
+inline void translateVectors(T * x, T * y, T dx, T dy, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] += dx;
+		y[i] += dy;
+	}
+}
+
+template<typename T>
+inline void scaleVectors(T * x, T * y, T scalar, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] *= scalar;
+		y[i] *= scalar;
+	}
+}
+
+template<typename T>
+inline void dotVectors(const T * x, const T * y, const T * otherX,
+		const T * otherY, T * out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = x[i] * otherX[i] + y[i] * otherY[i];
+	}
+}
+
+template<typename T>
+inline void normalizeVectors(T * x, T * y, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		TVector2<T> vector(x[i], y[i]);
+		vector.normalize();
+		x[i] = vector.getX();
+		y[i] = vector.getY();
+	}
+}
+
+template<typename T>
+inline void rotateVectors(T * x, T * y, T cosAngle, T sinAngle, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		T oldX = x[i];
+		x[i] = oldX * cosAngle - y[i] * sinAngle;
+		y[i] = y[i] * cosAngle + oldX * sinAngle;
+	}
+}
+
+template<typename T>
+inline void distanceVectors(const T * x, const T * y, const T * otherX,
+		const T * otherY, T * out, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = TVector2<T>(x[i], y[i]).distance(
+				TVector2<T>(otherX[i], otherY[i]));
+	}
+}
+
+template<typename T>
+inline void splitVectors(const TVector2<T> * vectors, T * x, T * y,
+		size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		x[i] = vectors[i].getX();
+		y[i] = vectors[i].getY();
+	}
+}
+
+template<typename T>
+inline void joinVectors(const T * x, const T * y, TVector2<T> * vectors,
+		size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		vectors[i].setX(x[i]);
+		vectors[i].setY(y[i]);
+	}
+}
+
+/*
+ * TVector2Array
+ */
+
+template<typename T>
+const size_t TVector2Array<T>::ALIGNMENT;
+
+template<typename T>
+inline TVector2Array<T>::TVector2Array() :
+				mBuffer(NULL),
+				mX(NULL),
+				mY(NULL),
+				mSize(0),
+				mCapacity(0)
+{
+}
+
+template<typename T>
+inline TVector2Array<T>::TVector2Array(size_t size) :
+				mBuffer(NULL),
+				mX(NULL),
+				mY(NULL),
+				mSize(0),
+				mCapacity(0)
+{
+	resize(size);
+}
+
+template<typename T>
+inline TVector2Array<T>::TVector2Array(const TVector2Array<T>& array) :
+				mBuffer(NULL),
+				mX(NULL),
+				mY(NULL),
+				mSize(0),
+				mCapacity(0)
+{
+	*this = array;
+}
+
+template<typename T>
+inline TVector2Array<T>& TVector2Array<T>::operator=(
+		const TVector2Array<T>& array)
+{
+	if (this == &array)
+	{
+		return *this;
+	}
+	if (mCapacity < array.mSize)
+	{
+		mSize = 0;
+		reallocate(array.mSize);
+	}
+	mSize = array.mSize;
+	if (mSize != 0)
+	{
+		std::memcpy(mX, array.mX, mSize * sizeof(T));
+		std::memcpy(mY, array.mY, mSize * sizeof(T));
+	}
+	return *this;
+}
+
+template<typename T>
+inline TVector2Array<T>::~TVector2Array()
+{
+	delete[] mBuffer;
+}
+
+template<typename T>
+inline size_t TVector2Array<T>::size() const
+{
+	return mSize;
+}
+
+template<typename T>
+inline bool TVector2Array<T>::empty() const
+{
+	return mSize == 0;
+}
+
+template<typename T>
+inline void TVector2Array<T>::resize(size_t size)
+{
+	reserve(size);
+	if (size > mSize)
+	{
+		std::memset(mX + mSize, 0, (size - mSize) * sizeof(T));
+		std::memset(mY + mSize, 0, (size - mSize) * sizeof(T));
+	}
+	mSize = size;
+}
+
+template<typename T>
+inline void TVector2Array<T>::reserve(size_t capacity)
+{
+	if (capacity > mCapacity)
+	{
+		reallocate(capacity);
+	}
+}
+
+template<typename T>
+inline void TVector2Array<T>::clear()
+{
+	mSize = 0;
+}
+
+template<typename T>
+inline void TVector2Array<T>::append(const TVector2<T>& vector)
+{
+	if (mSize == mCapacity)
+	{
+		reallocate(mCapacity ? mCapacity * 2 : 64);
+	}
+	mX[mSize] = vector.getX();
+	mY[mSize] = vector.getY();
+	++mSize;
+}
+
+template<typename T>
+inline TVector2<T> TVector2Array<T>::get(size_t index) const
+{
+	return TVector2<T>(mX[index], mY[index]);
+}
+
+template<typename T>
+inline void TVector2Array<T>::set(size_t index, const TVector2<T>& vector)
+{
+	mX[index] = vector.getX();
+	mY[index] = vector.getY();
+}
+
+template<typename T>
+inline T * TVector2Array<T>::getX()
+{
+	return mX;
+}
+
+template<typename T>
+inline T * TVector2Array<T>::getY()
+{
+	return mY;
+}
+
+template<typename T>
+inline const T * TVector2Array<T>::getX() const
+{
+	return mX;
+}
+
+template<typename T>
+inline const T * TVector2Array<T>::getY() const
+{
+	return mY;
+}
+
+template<typename T>
+inline void TVector2Array<T>::assign(const TVector2<T> * vectors,
+		size_t count)
+{
+	mSize = 0;
+	reserve(count);
+	mSize = count;
+	splitVectors(vectors, mX, mY, count);
+}
+
+template<typename T>
+inline void TVector2Array<T>::assign(const std::vector<TVector2<T> >& vectors)
+{
+	assign(vectors.empty() ? NULL : &vectors[0], vectors.size());
+}
+
+template<typename T>
+inline void TVector2Array<T>::copyTo(TVector2<T> * outVectors) const
+{
+	joinVectors(mX, mY, outVectors, mSize);
+}
+
+template<typename T>
+inline void TVector2Array<T>::copyTo(
+		std::vector<TVector2<T> >& outVectors) const
+{
+	outVectors.resize(mSize);
+	if (mSize != 0)
+	{
+		copyTo(&outVectors[0]);
+	}
+}
+
+template<typename T>
+inline void TVector2Array<T>::add(const TVector2Array<T>& other)
+{
+	assert(other.mSize == mSize);
+	addVectors(mX, mY, other.mX, other.mY, mSize);
+}
+
+template<typename T>
+inline void TVector2Array<T>::add(const TVector2<T>& offset)
+{
+	translateVectors(mX, mY, offset.getX(), offset.getY(), mSize);
+}
+
+template<typename T>
+inline void TVector2Array<T>::scale(T scalar)
+{
+	scaleVectors(mX, mY, scalar, mSize);
+}
+
+template<typename T>
+inline void TVector2Array<T>::normalize()
+{
+	normalizeVectors(mX, mY, mSize);
+}
+
+template<typename T>
+inline void TVector2Array<T>::rotate(float angle)
+{
+	// once for all the vectors, the same values as TVector2::rotate()
+	T cosAngle = static_cast<T>(cosf(angle * M_PI / 180));
+	T sinAngle = static_cast<T>(sinf(angle * M_PI / 180));
+	rotateVectors(mX, mY, cosAngle, sinAngle, mSize);
+}
+
+template<typename T>
+inline void TVector2Array<T>::dot(const TVector2Array<T>& other, T * out) const
+{
+	assert(other.mSize == mSize);
+	dotVectors(mX, mY, other.mX, other.mY, out, mSize);
+}
+
+template<typename T>
+inline void TVector2Array<T>::distance(const TVector2Array<T>& other,
+		T * out) const
+{
+	assert(other.mSize == mSize);
+	distanceVectors(mX, mY, other.mX, other.mY, out, mSize);
+}
+
+template<typename T>
+inline void TVector2Array<T>::reallocate(size_t capacity)
+{
+	// y starts aligned too, after a whole number of aligned blocks
+	const size_t perBlock = (ALIGNMENT >= sizeof(T)) ? ALIGNMENT / sizeof(T) : 1;
+	capacity = (capacity + perBlock - 1) / perBlock * perBlock;
+
+	char * buffer = new char[capacity * 2 * sizeof(T) + ALIGNMENT];
+	size_t misalignment = reinterpret_cast<size_t>(buffer) % ALIGNMENT;
+	T * x = reinterpret_cast<T *>(buffer
+			+ (misalignment ? ALIGNMENT - misalignment : 0));
+	T * y = x + capacity;
+
+	if (mSize != 0)
+	{
+		std::memcpy(x, mX, mSize * sizeof(T));
+		std::memcpy(y, mY, mSize * sizeof(T));
+	}
+	delete[] mBuffer;
+	mBuffer = buffer;
+	mX = x;
+	mY = y;
+	mCapacity = capacity;
+}
+
+} /* namespace Util */
+
+#endif /* TVECTOR2ARRAY_H_ */
@@ -0,0 +1,294 @@
+/*
+ * @file	TextPieceTable.h
+ * @date	2026-10-19
+ * @brief	Editable text made of pieces of unchanged buffers.
+ */
+
+#ifndef TEXTPIECETABLE_H_
+#define TEXTPIECETABLE_H_
+
+#include "Util/TextView.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Util
+{
+
+/**
+ * Editable text that never copies the text it starts from. The text is a
+ * sequence of pieces, each one pointing either in the original text or
+ * in an append-only buffer of the inserted characters.
+ *
+ * The pieces are kept in a balanced tree (a treap) that also counts the
+ * characters and line breaks under each node, so insert(), erase() and
+ * the line lookups are O(log n) whatever the size of the text.
+ *
+ * The tree is never modified in place: an edit builds the O(log n) nodes
+ * on its path and shares the rest with the previous version. Taking a
+ * Snapshot is then only a pointer copy, that's what the undo history
+ * keeps after each edit.
+ *
+ * The original text must stay valid as long as the table, and its
+ * snapshots, are used. The views given to forEachPiece() are valid until
+ * the next reset().
+ *
+ * Lines follow the TextResource rules: separated by '\n', a '\r' before
+ * it is not part of the line, and a break at the very end doesn't start
+ * another line.
+ */
+class TextPieceTable
+{
+	private:
+		struct Node;
+		typedef std::shared_ptr<const Node> NodePtr;
+
+	public:
+		/**
+		 * A version of the text, valid for the table that made it.
+		 */
+		class Snapshot
+		{
+			public:
+				Snapshot();
+				size_t getSize() const;
+
+			private:
+				friend class TextPieceTable;
+				NodePtr mRoot;
+		};
+
+		TextPieceTable();
+
+		/**
+		 * @param original text to edit, not copied
+		 */
+		explicit TextPieceTable(TextView original);
+
+		/**
+		 * Start again from a new original text, the history is cleared.
+		 */
+		void reset(TextView original);
+
+		size_t getSize() const;
+		bool empty() const;
+
+		/**
+		 * @return the number of pieces, a measure of the fragmentation
+		 */
+		size_t getPieceCount() const;
+
+		/**
+		 * @param offset clamped to getSize()
+		 * @param text copied in the table
+		 */
+		void insert(size_t offset, TextView text);
+
+		/**
+		 * @param offset clamped to getSize()
+		 * @param length clamped to what's left after offset
+		 */
+		void erase(size_t offset, size_t length);
+
+		/**
+		 * Replace length characters at offset by text, a single step in
+		 * the history.
+		 */
+		void replace(size_t offset, size_t length, TextView text);
+
+		/**
+		 * @return the character at offset, which must be < getSize()
+		 */
+		char at(size_t offset) const;
+
+		/**
+		 * Copy a range of the text.
+		 */
+		void copyText(size_t offset, size_t length, std::string& outText) const;
+		void copyText(std::string& outText) const;
+
+		/**
+		 * Call func(TextView) on each piece of a range, in order. The views
+		 * point in the original text or in the inserted characters, nothing
+		 * is copied.
+		 */
+		template<typename Func>
+		void forEachPiece(size_t offset, size_t length, Func func) const;
+
+		size_t getLineCount() const;
+
+		/**
+		 * @return the offset of the first character of a line,
+		 * getSize() if out of range.
+		 */
+		size_t getLineOffset(size_t line) const;
+
+		/**
+		 * @return the line holding the character at offset
+		 */
+		size_t getLineOfOffset(size_t offset) const;
+
+		/**
+		 * Copy a line without its line break, empty if out of range.
+		 */
+		void copyLine(size_t line, std::string& outLine) const;
+
+		/**
+		 * O(1), the snapshot shares every piece with the table.
+		 */
+		Snapshot getSnapshot() const;
+
+		/**
+		 * Go back, or forward, to a snapshot of this table. It is a single
+		 * step in the history.
+		 */
+		void restore(const Snapshot& snapshot);
+
+		/**
+		 * Every edit is a step in the history, until clearHistory().
+		 */
+		bool canUndo() const;
+		bool canRedo() const;
+		bool undo();
+		bool redo();
+		void clearHistory();
+
+		/**
+		 * Pieces of the original text longer than this are cut, so the line
+		 * breaks are never counted on more than this when a piece is split.
+		 */
+		static const size_t MAX_PIECE_SIZE = 4 * 1024;
+
+	private:
+		TextPieceTable(const TextPieceTable&);
+		TextPieceTable& operator=(const TextPieceTable&);
+
+		struct Node
+		{
+			TextView piece;
+			size_t pieceBreaks; /**< line breaks in the piece */
+			unsigned int priority; /**< higher than the children */
+			NodePtr left;
+			NodePtr right;
+			size_t size; /**< characters of the subtree */
+			size_t breaks; /**< line breaks of the subtree */
+			size_t pieces; /**< nodes of the subtree */
+		};
+
+		static NodePtr makeNode(TextView piece, size_t pieceBreaks,
+				unsigned int priority, const NodePtr& left, const NodePtr& right);
+
+		/**
+		 * Balanced tree of the pieces, in order.
+		 */
+		NodePtr build(const std::vector<TextView>& pieces, size_t begin,
+				size_t end);
+
+		static NodePtr merge(const NodePtr& left, const NodePtr& right);
+
+		/**
+		 * Cut the tree at offset, a piece across it is cut in two.
+		 */
+		static void split(const NodePtr& node, size_t offset, NodePtr& outLeft,
+				NodePtr& outRight);
+
+		/**
+		 * Put a single node at offset, copying only the nodes on its path.
+		 */
+		static NodePtr insertNode(const NodePtr& node, size_t offset,
+				const NodePtr& inserted);
+
+		/**
+		 * Grow the piece whose last character is at offset by the added
+		 * characters, when they follow it in memory.
+		 * @return the new tree, NULL if the piece can't grow
+		 */
+		static NodePtr extendPiece(const NodePtr& node, size_t offset,
+				TextView added);
+
+		/**
+		 * @return the offset of a line break, counting from 0
+		 */
+		size_t findBreak(size_t index) const;
+
+		template<typename Func>
+		static void visit(const Node * node, size_t offset, size_t begin,
+				size_t end, Func& func);
+
+		/**
+		 * Copy text in the add buffers, its characters stay at the same
+		 * address until reset().
+		 */
+		TextView append(TextView text);
+
+		/**
+		 * Tree of the inserted text, after the add buffers
+		 */
+		NodePtr makePieces(TextView text);
+
+		NodePtr insertInto(const NodePtr& root, size_t offset, TextView text);
+		static NodePtr eraseFrom(const NodePtr& root, size_t offset,
+				size_t length);
+
+		void pushHistory();
+
+		unsigned int nextPriority();
+
+		NodePtr mRoot;
+		std::list<std::string> mAddBuffers; /**< never reallocated */
+		std::vector<NodePtr> mUndo;
+		std::vector<NodePtr> mRedo;
+		unsigned int mSeed; /**< of the priorities */
+};
+
+template<typename Func>
+inline void TextPieceTable::forEachPiece(size_t offset, size_t length,
+		Func func) const
+{
+	size_t size = getSize();
+	if (offset >= size)
+	{
+		return;
+	}
+	size_t end = (length > size - offset) ? size : offset + length;
+	visit(mRoot.get(), 0, offset, end, func);
+}
+
+template<typename Func>
+inline void TextPieceTable::visit(const Node * node, size_t offset,
+		size_t begin, size_t end, Func& func)
+{
+	// offset is where the subtree starts in the text
+	while (node != NULL && begin < end)
+	{
+		size_t leftSize = node->left ? node->left->size : 0;
+		size_t pieceBegin = offset + leftSize;
+		size_t pieceEnd = pieceBegin + node->piece.size();
+
+		if (begin < pieceBegin)
+		{
+			visit(node->left.get(), offset, begin, end, func);
+		}
+		if (begin < pieceEnd && end > pieceBegin)
+		{
+			size_t from = (begin > pieceBegin) ? begin - pieceBegin : 0;
+			size_t to = (end < pieceEnd) ? end - pieceBegin : node->piece.size();
+			func(node->piece.substr(from, to - from));
+		}
+		if (end <= pieceEnd)
+		{
+			return;
+		}
+
+		// the right subtree, without recursion
+		offset = pieceEnd;
+		node = node->right.get();
+	}
+}
+
+}
+
+#endif /* TEXTPIECETABLE_H_ */
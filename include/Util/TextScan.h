@@ -0,0 +1,31 @@
+/*
+ * @file	TextScan.h
+ * @date	2026-10-19
+ * @brief	Vectorized byte scanning over large buffers.
+ */
+
+#ifndef TEXTSCAN_H_
+#define TEXTSCAN_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace Util
+{
+
+/**
+ * Count the occurrences of a byte, e.g. the newlines of a text.
+ * Uses SSE2 (or AVX2 when compiled with it), 16 or 32 bytes at a time.
+ */
+size_t countByte(const char * data, size_t size, char c);
+
+/**
+ * Append the position of every occurrence of a byte to outPositions.
+ * @param baseOffset added to each position, to scan a buffer in parts
+ */
+void findByte(const char * data, size_t size, char c,
+		std::vector<size_t>& outPositions, size_t baseOffset = 0);
+
+}
+
+#endif /* TEXTSCAN_H_ */
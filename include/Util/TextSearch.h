@@ -0,0 +1,101 @@
+/*
+ * @file	TextSearch.h
+ * @date	2026-10-19
+ * @brief	Substring and multi-pattern search over large texts.
+ */
+
+#ifndef TEXTSEARCH_H_
+#define TEXTSEARCH_H_
+
+#include "Util/TextView.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Util
+{
+
+/**
+ * A pattern found in a text
+ */
+struct TextMatch
+{
+	size_t offset; /**< of the first character of the match */
+	size_t length;
+	size_t pattern; /**< index of the pattern in its TextPatternSet, 0 for a single pattern */
+	size_t line; /**< filled by TextResource, 0 otherwise */
+};
+
+/**
+ * First occurrence of pattern in text, at or after from.
+ * SIMD filter on the first and last byte of the pattern, only the
+ * positions where both match are compared.
+ * @return the offset, or std::string::npos if not found
+ */
+size_t findFirst(TextView text, TextView pattern, size_t from = 0);
+
+/**
+ * Append the offset of every occurrence, overlapping ones included.
+ */
+void findAll(TextView text, TextView pattern, std::vector<size_t>& outOffsets);
+
+/**
+ * Finds any number of patterns in a single pass over the text, with an
+ * Aho-Corasick automaton. Add the patterns, call build() once, then
+ * search as many texts as needed. The search functions are const and
+ * can be called from several threads.
+ *
+ * The transition table only has a column for the bytes used by the
+ * patterns, all the other bytes share one column.
+ */
+class TextPatternSet
+{
+	public:
+		TextPatternSet();
+
+		/**
+		 * @param pattern empty patterns are ignored
+		 * @return the index of the pattern, reported in the matches
+		 */
+		size_t addPattern(TextView pattern);
+		size_t getPatternCount() const;
+		TextView getPattern(size_t index) const;
+
+		/**
+		 * Build the automaton, must be called after adding the patterns
+		 * and before searching.
+		 */
+		void build();
+		bool isBuilt() const;
+
+		/**
+		 * Append every occurrence of every pattern, sorted by the
+		 * offset of their last character.
+		 */
+		void findAll(TextView text, std::vector<TextMatch>& outMatches) const;
+
+		/**
+		 * Search a text given in consecutive parts. Start with a state of
+		 * 0 and pass the state returned by the previous part, matches
+		 * across parts are found.
+		 * @param baseOffset offset of this part in the whole text
+		 * @return the state to pass with the next part
+		 */
+		unsigned int scan(TextView part, size_t baseOffset, unsigned int state,
+				std::vector<TextMatch>& outMatches) const;
+
+	private:
+		std::vector<std::string> mPatterns;
+
+		unsigned short mByteClass[256]; /**< byte to column of mTransitions, up to 256 */
+		unsigned int mClassCount;
+		std::vector<unsigned int> mTransitions; /**< state * mClassCount + class */
+		std::vector<unsigned int> mOutputStart; /**< per state, in mOutputs, one extra at the end */
+		std::vector<unsigned int> mOutputs; /**< pattern indices */
+		bool mBuilt;
+};
+
+}
+
+#endif /* TEXTSEARCH_H_ */
@@ -0,0 +1,159 @@
+/*
+ * @file	TextView.h
+ * @date	2026-10-19
+ * @brief	Non-owning view of a range of characters.
+ */
+
+#ifndef TEXTVIEW_H_
+#define TEXTVIEW_H_
+
+#include <string>
+#include <cstddef>
+#include <cstring>
+
+namespace Util
+{
+
+/**
+ * Pointer and size of characters owned by someone else, usually a
+ * TextResource. It stays valid as long as the owner doesn't change.
+ */
+class TextView
+{
+	public:
+		TextView();
+		TextView(const char * data, size_t size);
+		TextView(const char * str);
+		TextView(const std::string& str);
+
+		const char * data() const;
+		size_t size() const;
+		bool empty() const;
+
+		const char * begin() const;
+		const char * end() const;
+
+		char operator[](size_t pos) const;
+
+		/**
+		 * @param pos first character, clamped to size()
+		 * @param count clamped to what's left after pos
+		 */
+		TextView substr(size_t pos, size_t count = std::string::npos) const;
+
+		/**
+		 * @return the first position of c at or after pos, npos if none
+		 */
+		size_t find(char c, size_t pos = 0) const;
+
+		/**
+		 * @return a copy of the characters
+		 */
+		std::string str() const;
+
+		bool operator==(const TextView& v2) const;
+		bool operator!=(const TextView& v2) const;
+
+	private:
+		const char * mData;
+		size_t mSize;
+};
+
+inline TextView::TextView() :
+				mData(NULL),
+				mSize(0)
+{
+}
+
+inline TextView::TextView(const char * data, size_t size) :
+				mData(data),
+				mSize(size)
+{
+}
+
+inline TextView::TextView(const char * str) :
+				mData(str),
+				mSize(str ? std::strlen(str) : 0)
+{
+}
+
+inline TextView::TextView(const std::string& str) :
+				mData(str.data()),
+				mSize(str.size())
+{
+}
+
+inline const char * TextView::data() const
+{
+	return mData;
+}
+
+inline size_t TextView::size() const
+{
+	return mSize;
+}
+
+inline bool TextView::empty() const
+{
+	return mSize == 0;
+}
+
+inline const char * TextView::begin() const
+{
+	return mData;
+}
+
+inline const char * TextView::end() const
+{
+	return mData + mSize;
+}
+
+inline char TextView::operator[](size_t pos) const
+{
+	return mData[pos];
+}
+
+inline TextView TextView::substr(size_t pos, size_t count) const
+{
+	if (pos > mSize)
+	{
+		pos = mSize;
+	}
+	if (count > mSize - pos)
+	{
+		count = mSize - pos;
+	}
+	return TextView(mData + pos, count);
+}
+
+inline size_t TextView::find(char c, size_t pos) const
+{
+	if (pos >= mSize)
+	{
+		return std::string::npos;
+	}
+	const void * found = std::memchr(mData + pos, c, mSize - pos);
+	return found ?
+			static_cast<size_t>(static_cast<const char *>(found) - mData) :
+			std::string::npos;
+}
+
+inline std::string TextView::str() const
+{
+	return std::string(mData, mSize);
+}
+
+inline bool TextView::operator==(const TextView& v2) const
+{
+	return (mSize == v2.mSize)
+			&& (mSize == 0 || std::memcmp(mData, v2.mData, mSize) == 0);
+}
+
+inline bool TextView::operator!=(const TextView& v2) const
+{
+	return !(*this == v2);
+}
+
+} /* namespace Util */
+
+#endif /* TEXTVIEW_H_ */
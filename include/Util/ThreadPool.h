@@ -0,0 +1,78 @@
+/**
+ *  @file		ThreadPool.h
+ *  @brief     	Fixed set of worker threads to split work across cores.
+ *  @details	parallelFor() hands indices 0..count-1 to the workers and
+ *  			the calling thread, and returns once all of them are done.
+ *
+ *  			ThreadPool pool; // one worker per core
+ *  			pool.parallelFor(items.size(), processItem);
+ *
+ *  			Only one parallelFor may run at a time on a pool.
+ *
+ *  @date      	2026-10-19
+ *  @copyright 	Prismal Studio 2008-2013 www.prismalstudio.com
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+
+namespace Util
+{
+
+class ThreadPool
+{
+	public:
+		/**
+		 * @param threadCount number of workers, 0 to use one per core
+		 * minus the calling thread.
+		 */
+		explicit ThreadPool(unsigned int threadCount = 0);
+		~ThreadPool();
+
+		/**
+		 * Call task(i) for every i in [0, count), blocks until done.
+		 * @param count number of tasks
+		 * @param task called concurrently, must be thread safe
+		 */
+		void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+		/**
+		 * @return the number of worker threads, the caller not included
+		 */
+		unsigned int getThreadCount() const;
+
+	private:
+		ThreadPool(const ThreadPool&);
+		ThreadPool& operator=(const ThreadPool&);
+
+		void workerLoop();
+
+		/**
+		 * Take indices until there's none left
+		 */
+		void runTasks();
+
+		std::vector<std::thread> mWorkers;
+		std::mutex mMutex;
+		std::condition_variable mWorkReady; /**< a batch was posted */
+		std::condition_variable mWorkDone; /**< a worker finished a batch */
+
+		const std::function<void(size_t)>* mTask; /**< current batch */
+		size_t mCount;
+		std::atomic<size_t> mNext; /**< next index to take */
+		unsigned int mBatch; /**< incremented for each batch */
+		unsigned int mBusyWorkers;
+		bool mStop;
+};
+
+} /* namespace Util */
+
+#endif /* THREADPOOL_H_ */
@@ -0,0 +1,226 @@
+/*
+ * @file	Compression.cpp
+ * @date	2026-10-19
+ * @brief	Fast block compression, LZ4 block format.
+ */
+
+#include "Util/Compression.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+const size_t MIN_MATCH = 4;
+const size_t LAST_LITERALS = 5; /**< the block always ends with literals */
+const size_t MATCH_FIND_LIMIT = 12; /**< no match starts in the last bytes */
+const size_t MAX_OFFSET = 65535;
+const int HASH_BITS = 14;
+
+inline unsigned int read32(const unsigned char * p)
+{
+	unsigned int value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+inline unsigned int hash32(unsigned int sequence)
+{
+	return (sequence * 2654435761U) >> (32 - HASH_BITS);
+}
+
+/**
+ * Write a length in the 255-continuation form, after its 15 in the token
+ */
+inline unsigned char * writeLength(unsigned char * op, size_t length)
+{
+	while (length >= 255)
+	{
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = static_cast<unsigned char>(length);
+	return op;
+}
+
+/**
+ * Write a sequence: token, literals, and the match if matchLength > 0
+ */
+unsigned char * writeSequence(unsigned char * op, const unsigned char * literals,
+		size_t literalLength, size_t offset, size_t matchLength)
+{
+	unsigned char * token = op++;
+	*token = static_cast<unsigned char>(
+			(literalLength >= 15 ? 15 : literalLength) << 4);
+	if (literalLength >= 15)
+	{
+		op = writeLength(op, literalLength - 15);
+	}
+	std::memcpy(op, literals, literalLength);
+	op += literalLength;
+
+	if (matchLength > 0)
+	{
+		*op++ = static_cast<unsigned char>(offset & 0xFF);
+		*op++ = static_cast<unsigned char>(offset >> 8);
+
+		size_t code = matchLength - MIN_MATCH;
+		*token |= static_cast<unsigned char>(code >= 15 ? 15 : code);
+		if (code >= 15)
+		{
+			op = writeLength(op, code - 15);
+		}
+	}
+	return op;
+}
+
+}
+
+void Util::lz4Compress(const char * data, size_t size,
+		std::string& outCompressed)
+{
+	outCompressed.resize(size + size / 255 + 16);
+	unsigned char * out = reinterpret_cast<unsigned char *>(&outCompressed[0]);
+	unsigned char * op = out;
+
+	const unsigned char * src = reinterpret_cast<const unsigned char *>(data);
+	const unsigned char * end = src + size;
+	const unsigned char * anchor = src; // start of the pending literals
+
+	if (size > MATCH_FIND_LIMIT)
+	{
+		const unsigned char * matchLimit = end - LAST_LITERALS;
+		const unsigned char * findLimit = end - MATCH_FIND_LIMIT;
+
+		// last position + 1 of each hashed sequence, 0 for none
+		std::vector<size_t> table(size_t(1) << HASH_BITS, 0);
+
+		const unsigned char * ip = src;
+		while (ip < findLimit)
+		{
+			unsigned int sequence = read32(ip);
+			size_t& entry = table[hash32(sequence)];
+			const unsigned char * ref = (entry != 0) ? src + entry - 1 : NULL;
+			entry = static_cast<size_t>(ip - src) + 1;
+
+			if (ref == NULL || static_cast<size_t>(ip - ref) > MAX_OFFSET
+					|| read32(ref) != sequence)
+			{
+				++ip;
+				continue;
+			}
+
+			// extend the match forward
+			const unsigned char * matchEnd = ip + MIN_MATCH;
+			const unsigned char * refEnd = ref + MIN_MATCH;
+			while (matchEnd < matchLimit && *matchEnd == *refEnd)
+			{
+				++matchEnd;
+				++refEnd;
+			}
+
+			op = writeSequence(op, anchor, ip - anchor, ip - ref,
+					matchEnd - ip);
+			ip = matchEnd;
+			anchor = ip;
+		}
+	}
+
+	op = writeSequence(op, anchor, end - anchor, 0, 0);
+	outCompressed.resize(op - out);
+}
+
+bool Util::lz4Decompress(const char * compressed, size_t compressedSize,
+		char * out, size_t outSize)
+{
+	const unsigned char * ip =
+			reinterpret_cast<const unsigned char *>(compressed);
+	const unsigned char * ipEnd = ip + compressedSize;
+	unsigned char * op = reinterpret_cast<unsigned char *>(out);
+	unsigned char * opEnd = op + outSize;
+
+	while (ip < ipEnd)
+	{
+		unsigned int token = *ip++;
+
+		// literals
+		size_t length = token >> 4;
+		if (length == 15)
+		{
+			unsigned int more;
+			do
+			{
+				if (ip >= ipEnd)
+				{
+					return false;
+				}
+				more = *ip++;
+				length += more;
+			} while (more == 255);
+		}
+		if (length > static_cast<size_t>(ipEnd - ip)
+				|| length > static_cast<size_t>(opEnd - op))
+		{
+			return false;
+		}
+		std::memcpy(op, ip, length);
+		ip += length;
+		op += length;
+
+		// the last sequence has no match
+		if (ip == ipEnd)
+		{
+			break;
+		}
+
+		if (ipEnd - ip < 2)
+		{
+			return false;
+		}
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0
+				|| offset > static_cast<size_t>(op
+						- reinterpret_cast<unsigned char *>(out)))
+		{
+			return false;
+		}
+
+		length = token & 0x0F;
+		if (length == 15)
+		{
+			unsigned int more;
+			do
+			{
+				if (ip >= ipEnd)
+				{
+					return false;
+				}
+				more = *ip++;
+				length += more;
+			} while (more == 255);
+		}
+		length += MIN_MATCH;
+		if (length > static_cast<size_t>(opEnd - op))
+		{
+			return false;
+		}
+
+		// byte by byte, the match can overlap what it writes
+		const unsigned char * match = op - offset;
+		if (offset >= length)
+		{
+			std::memcpy(op, match, length);
+			op += length;
+		}
+		else
+		{
+			for (size_t i = 0; i < length; ++i)
+			{
+				*op++ = *match++;
+			}
+		}
+	}
+	return op == opEnd;
+}
@@ -8,6 +8,24 @@
 #include "Util/FileHelper.h"
 #include <sys/stat.h> /* stat function in fileExist */
 #include <fstream> /* readFile uses ifstream */
+#include <cstdio> /* rename in writeFile */
+#include <atomic> /* temporary file counter */
+#ifdef _WIN32
+#include <direct.h> /* _mkdir */
+#include <process.h> /* _getpid */
+#else
+#include <unistd.h> /* getpid */
+#endif
+
+namespace
+{
+
+/**
+ * Temporary files written by this process, for unique names
+ */
+std::atomic<unsigned long> sTempFileCount(0);
+
+}
 
 bool Util::fileExist(const std::string& filename)
 {
@@ -39,3 +57,55 @@ bool Util::readFile(const std::string& filename, std::string& outContent)
 	t.read(&outContent[0], size);
 	return true;
 }
+
+bool Util::writeFile(const std::string& filename, const char * data,
+		size_t size)
+{
+	// unique, another thread or process may write the same file
+#ifdef _WIN32
+	long processId = _getpid();
+#else
+	long processId = getpid();
+#endif
+	std::string tempName = filename + "." + std::to_string(processId) + "."
+			+ std::to_string(sTempFileCount++) + ".tmp";
+	{
+		std::ofstream t(tempName.c_str(), std::ios::binary | std::ios::trunc);
+		if (t.fail())
+		{
+			return false; // can't create file
+		}
+		t.write(data, size);
+		if (t.fail())
+		{
+			t.close();
+			std::remove(tempName.c_str());
+			return false;
+		}
+	}
+
+#ifdef _WIN32
+	// rename doesn't replace an existing file on Windows
+	std::remove(filename.c_str());
+#endif
+	if (std::rename(tempName.c_str(), filename.c_str()) != 0)
+	{
+		std::remove(tempName.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool Util::makeDirectory(const std::string& path)
+{
+	struct stat buffer;
+	if (stat(path.c_str(), &buffer) == 0)
+	{
+		return (buffer.st_mode & S_IFDIR) != 0;
+	}
+#ifdef _WIN32
+	return _mkdir(path.c_str()) == 0;
+#else
+	return mkdir(path.c_str(), 0755) == 0;
+#endif
+}
@@ -0,0 +1,38 @@
+/*
+ * @file	Hash.cpp
+ * @date	2026-10-19
+ * @brief	Non-cryptographic hash functions.
+ */
+
+#include "Util/Hash.h"
+
+unsigned long long Util::hashFnv1a(const char * data, size_t size,
+		unsigned long long seed)
+{
+	const unsigned long long prime = 1099511628211ULL;
+	unsigned long long hash = seed;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= prime;
+	}
+	return hash;
+}
+
+unsigned long long Util::hashFnv1a(const std::string& str,
+		unsigned long long seed)
+{
+	return hashFnv1a(str.data(), str.size(), seed);
+}
+
+std::string Util::hashToHex(unsigned long long hash)
+{
+	const char digits[] = "0123456789abcdef";
+	std::string hex(16, '0');
+	for (int i = 15; i >= 0; --i)
+	{
+		hex[i] = digits[hash & 0xF];
+		hash >>= 4;
+	}
+	return hex;
+}
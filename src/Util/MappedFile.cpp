@@ -0,0 +1,184 @@
+/*
+ * @file	MappedFile.cpp
+ * @date	2026-10-19
+ * @brief	Read-only memory mapping of a whole file.
+ */
+
+#include "Util/MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Util
+{
+
+MappedFile::MappedFile() :
+				mData(NULL),
+				mSize(0),
+				mOpen(false)
+#ifdef _WIN32
+				, mFileHandle(INVALID_HANDLE_VALUE),
+				mMappingHandle(NULL)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filename)
+{
+	close();
+
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ,
+			FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	mFileHandle = file;
+	mSize = static_cast<size_t>(size.QuadPart);
+	mOpen = true;
+
+	// a mapping of size 0 isn't allowed
+	if (mSize == 0)
+	{
+		return true;
+	}
+
+	mMappingHandle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mMappingHandle == NULL)
+	{
+		close();
+		return false;
+	}
+
+	mData = static_cast<const char *>(MapViewOfFile(mMappingHandle,
+			FILE_MAP_READ, 0, 0, 0));
+	if (mData == NULL)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mData)
+	{
+		UnmapViewOfFile(mData);
+	}
+	if (mMappingHandle)
+	{
+		CloseHandle(mMappingHandle);
+	}
+	if (mFileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(mFileHandle);
+	}
+	mData = NULL;
+	mSize = 0;
+	mOpen = false;
+	mMappingHandle = NULL;
+	mFileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filename)
+{
+	close();
+
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat buffer;
+	if (fstat(fd, &buffer) != 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	mSize = static_cast<size_t>(buffer.st_size);
+	if (mSize > 0)
+	{
+		void * view = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (view == MAP_FAILED)
+		{
+			::close(fd);
+			mSize = 0;
+			return false;
+		}
+		mData = static_cast<const char *>(view);
+	}
+
+	// the mapping keeps its own reference to the file
+	::close(fd);
+	mOpen = true;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mData)
+	{
+		munmap(const_cast<char *>(mData), mSize);
+	}
+	mData = NULL;
+	mSize = 0;
+	mOpen = false;
+}
+
+#endif
+
+void MappedFile::swap(MappedFile& other)
+{
+	std::swap(mData, other.mData);
+	std::swap(mSize, other.mSize);
+	std::swap(mOpen, other.mOpen);
+#ifdef _WIN32
+	std::swap(mFileHandle, other.mFileHandle);
+	std::swap(mMappingHandle, other.mMappingHandle);
+#endif
+}
+
+bool MappedFile::isOpen() const
+{
+	return mOpen;
+}
+
+const char * MappedFile::getData() const
+{
+	return mData;
+}
+
+size_t MappedFile::getSize() const
+{
+	return mSize;
+}
+
+} /* namespace Util */
@@ -0,0 +1,261 @@
+/*
+ * @file	LuaAllocator.cpp
+ * @date	2026-10-19
+ * @brief	Size-class arena allocator for Lua states.
+ */
+
+#include "Util/Resource/LuaAllocator.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace Util
+{
+
+const size_t LuaAllocator::MAX_SMALL_SIZE;
+const size_t LuaAllocator::ARENA_BLOCK_SIZE;
+const size_t LuaAllocator::SIZE_CLASS_STEP;
+const size_t LuaAllocator::SIZE_CLASS_COUNT;
+
+namespace
+{
+
+/**
+ * Same as the one of luaL_newstate()
+ */
+int panic(lua_State * state)
+{
+	std::fprintf(stderr, "PANIC: unprotected error in call to Lua API (%s)\n",
+			lua_tostring(state, -1));
+	return 0;
+}
+
+}
+
+LuaAllocator::LuaAllocator() :
+				mCursor(NULL),
+				mLimit(NULL),
+				mClosing(false),
+				mUsedSize(0),
+				mPeakSize(0),
+				mLargeSize(0),
+				mAllocationCount(0),
+				mMallocCount(0)
+{
+	std::memset(mFreeLists, 0, sizeof(mFreeLists));
+}
+
+LuaAllocator::~LuaAllocator()
+{
+	releaseAll();
+}
+
+void * LuaAllocator::allocate(void * userData, void * ptr, size_t oldSize,
+		size_t newSize)
+{
+	LuaAllocator * allocator = static_cast<LuaAllocator *>(userData);
+	if (newSize == 0)
+	{
+		if (ptr != NULL)
+		{
+			allocator->freeBlock(ptr, oldSize);
+		}
+		return NULL;
+	}
+	if (ptr == NULL)
+	{
+		return allocator->allocateBlock(newSize);
+	}
+	return allocator->reallocateBlock(ptr, oldSize, newSize);
+}
+
+lua_State * LuaAllocator::newState()
+{
+	lua_State * state = lua_newstate(allocate, this);
+	if (state)
+	{
+		lua_atpanic(state, panic);
+	}
+	return state;
+}
+
+void LuaAllocator::beginClose()
+{
+	mClosing = true;
+}
+
+void LuaAllocator::releaseAll()
+{
+	for (size_t i = 0; i < mArenaBlocks.size(); ++i)
+	{
+		::operator delete(mArenaBlocks[i]);
+	}
+	mArenaBlocks.clear();
+	mCursor = NULL;
+	mLimit = NULL;
+	std::memset(mFreeLists, 0, sizeof(mFreeLists));
+	mClosing = false;
+
+	// the big blocks were freed by Lua one by one
+	mUsedSize = mLargeSize;
+}
+
+size_t LuaAllocator::getUsedSize() const
+{
+	return mUsedSize;
+}
+
+size_t LuaAllocator::getPeakSize() const
+{
+	return mPeakSize;
+}
+
+size_t LuaAllocator::getReservedSize() const
+{
+	return mArenaBlocks.size() * ARENA_BLOCK_SIZE + mLargeSize;
+}
+
+unsigned long LuaAllocator::getAllocationCount() const
+{
+	return mAllocationCount;
+}
+
+unsigned long LuaAllocator::getMallocCount() const
+{
+	return mMallocCount;
+}
+
+size_t LuaAllocator::getSizeClass(size_t size)
+{
+	return (size + SIZE_CLASS_STEP - 1) / SIZE_CLASS_STEP - 1;
+}
+
+void * LuaAllocator::allocateBlock(size_t size)
+{
+	void * ptr;
+	if (size <= MAX_SMALL_SIZE)
+	{
+		ptr = allocateSmall(getSizeClass(size));
+	}
+	else
+	{
+		ptr = std::malloc(size);
+		if (ptr)
+		{
+			mLargeSize += size;
+			++mMallocCount;
+		}
+	}
+
+	if (ptr)
+	{
+		++mAllocationCount;
+		mUsedSize += size;
+		if (mUsedSize > mPeakSize)
+		{
+			mPeakSize = mUsedSize;
+		}
+	}
+	return ptr;
+}
+
+void LuaAllocator::freeBlock(void * ptr, size_t size)
+{
+	mUsedSize -= size;
+	if (size > MAX_SMALL_SIZE)
+	{
+		mLargeSize -= size;
+		std::free(ptr);
+		return;
+	}
+
+	// at close the whole arena goes at once
+	if (!mClosing)
+	{
+		FreeBlock * block = static_cast<FreeBlock *>(ptr);
+		size_t sizeClass = getSizeClass(size);
+		block->next = mFreeLists[sizeClass];
+		mFreeLists[sizeClass] = block;
+	}
+}
+
+void * LuaAllocator::reallocateBlock(void * ptr, size_t oldSize,
+		size_t newSize)
+{
+	bool oldSmall = (oldSize <= MAX_SMALL_SIZE);
+	bool newSmall = (newSize <= MAX_SMALL_SIZE);
+
+	if (oldSmall && newSmall && getSizeClass(oldSize) == getSizeClass(newSize))
+	{
+		mUsedSize = mUsedSize - oldSize + newSize;
+		if (mUsedSize > mPeakSize)
+		{
+			mPeakSize = mUsedSize;
+		}
+		return ptr;
+	}
+
+	if (!oldSmall && !newSmall)
+	{
+		void * newPtr = std::realloc(ptr, newSize);
+		if (newPtr == NULL)
+		{
+			// Lua never expects a shrinking block to fail
+			return (newSize <= oldSize) ? ptr : NULL;
+		}
+		++mMallocCount;
+		mLargeSize = mLargeSize - oldSize + newSize;
+		mUsedSize = mUsedSize - oldSize + newSize;
+		if (mUsedSize > mPeakSize)
+		{
+			mPeakSize = mUsedSize;
+		}
+		return newPtr;
+	}
+
+	// moving between the arena and malloc
+	void * newPtr = allocateBlock(newSize);
+	if (newPtr == NULL)
+	{
+		// the smaller size Lua gives back later still fits the old block,
+		// a big one ends up in a free list: lost, but only out of memory
+		return (newSize <= oldSize) ? ptr : NULL;
+	}
+	std::memcpy(newPtr, ptr, (oldSize < newSize) ? oldSize : newSize);
+	freeBlock(ptr, oldSize);
+	return newPtr;
+}
+
+void * LuaAllocator::allocateSmall(size_t sizeClass)
+{
+	FreeBlock * block = mFreeLists[sizeClass];
+	if (block)
+	{
+		mFreeLists[sizeClass] = block->next;
+		return block;
+	}
+
+	size_t size = (sizeClass + 1) * SIZE_CLASS_STEP;
+	if (mCursor == NULL || static_cast<size_t>(mLimit - mCursor) < size)
+	{
+		// the end of the previous arena block is left unused
+		char * arena = static_cast<char *>(::operator new(ARENA_BLOCK_SIZE,
+				std::nothrow));
+		if (arena == NULL)
+		{
+			return NULL;
+		}
+		mArenaBlocks.push_back(arena);
+		++mMallocCount;
+		mCursor = arena;
+		mLimit = arena + ARENA_BLOCK_SIZE;
+	}
+
+	void * ptr = mCursor;
+	mCursor += size;
+	return ptr;
+}
+
+} /* namespace Util */
@@ -0,0 +1,122 @@
+/*
+ * @file	LuaFunctionRef.cpp
+ * @date	2026-10-19
+ * @brief	Lua function looked up once, called from C++ many times.
+ */
+
+#include "Util/Resource/LuaFunctionRef.h"
+
+namespace Util
+{
+
+LuaFunctionRef::LuaFunctionRef() :
+				mResource(NULL),
+				mRef(LUA_NOREF),
+				mStateId(0),
+				mLoadCount(0)
+{
+}
+
+LuaFunctionRef::LuaFunctionRef(LuaResource& resource, const LuaPath& path) :
+				mResource(&resource),
+				mPath(path),
+				mRef(LUA_NOREF),
+				mStateId(0),
+				mLoadCount(0)
+{
+}
+
+LuaFunctionRef::LuaFunctionRef(LuaFunctionRef&& function) :
+				mResource(function.mResource),
+				mPath(function.mPath),
+				mRef(function.mRef),
+				mStateId(function.mStateId),
+				mLoadCount(function.mLoadCount)
+{
+	function.mResource = NULL;
+	function.mRef = LUA_NOREF;
+}
+
+LuaFunctionRef& LuaFunctionRef::operator=(LuaFunctionRef&& function)
+{
+	if (this != &function)
+	{
+		release();
+		mResource = function.mResource;
+		mPath = function.mPath;
+		mRef = function.mRef;
+		mStateId = function.mStateId;
+		mLoadCount = function.mLoadCount;
+		function.mResource = NULL;
+		function.mRef = LUA_NOREF;
+	}
+	return *this;
+}
+
+LuaFunctionRef::~LuaFunctionRef()
+{
+	release();
+}
+
+bool LuaFunctionRef::isValid()
+{
+	if (!push())
+	{
+		return false;
+	}
+	lua_pop(mResource->getState(), 1);
+	return true;
+}
+
+const LuaPath& LuaFunctionRef::getPath() const
+{
+	return mPath;
+}
+
+bool LuaFunctionRef::push()
+{
+	if (mResource == NULL || mResource->getState() == NULL)
+	{
+		return false;
+	}
+	lua_State * state = mResource->getState();
+
+	// a script ran since, the name may now be another function
+	if (mRef == LUA_NOREF || mStateId != mResource->mStateId
+			|| mLoadCount != mResource->mLoadCount)
+	{
+		release();
+		mStateId = mResource->mStateId;
+		mLoadCount = mResource->mLoadCount;
+
+		mPath.push(state);
+		if (!lua_isfunction(state, -1))
+		{
+			// not looked up again until the next script
+			lua_pop(state, 1);
+			mRef = LUA_REFNIL;
+			return false;
+		}
+		mRef = luaL_ref(state, LUA_REGISTRYINDEX);
+	}
+	if (mRef == LUA_REFNIL)
+	{
+		return false;
+	}
+
+	lua_rawgeti(state, LUA_REGISTRYINDEX, mRef);
+	return true;
+}
+
+void LuaFunctionRef::release()
+{
+	// the references of a closed state went with it
+	if (mRef >= 0 && mResource->mStateId == mStateId
+			&& mResource->getState() != NULL)
+	{
+		luaL_unref(mResource->getState(), LUA_REGISTRYINDEX, mRef);
+	}
+	mRef = LUA_NOREF;
+}
+
+} /* namespace Util */
@@ -0,0 +1,844 @@
+/*
+ * @file	LuaGeometry.cpp
+ * @date	2026-10-19
+ * @brief	TVector2 and TRectangle as Lua userdata.
+ */
+
+#include "Util/Resource/LuaGeometry.h"
+
+extern "C"
+{
+#include "lauxlib.h"
+}
+
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace Util
+{
+
+namespace
+{
+
+const char * VECTOR2_TYPE = "Util.Vector2";
+const char * RECTANGLE_TYPE = "Util.Rectangle";
+const char * VECTOR2_ARRAY_TYPE = "Util.Vector2Array";
+
+/**
+ * Every function of the module has the three metatables as upvalues, so
+ * checking a type is comparing with one of them, without looking its
+ * name up in the registry.
+ */
+enum Type
+{
+	VECTOR2 = 1, RECTANGLE, VECTOR2_ARRAY
+};
+
+const char * TYPE_NAMES[] =
+{
+	NULL, "Vector2", "Rectangle", "Vector2Array"
+};
+
+/**
+ * A Vector2Array userdata is the count followed by the coordinates
+ */
+struct ArrayHeader
+{
+	size_t count;
+};
+
+void * checkType(lua_State * state, int index, Type type)
+{
+	void * data = lua_touserdata(state, index);
+	if (data != NULL && lua_getmetatable(state, index))
+	{
+		bool sameType = lua_rawequal(state, -1, lua_upvalueindex(type)) != 0;
+		lua_pop(state, 1);
+		if (sameType)
+		{
+			return data;
+		}
+	}
+	luaL_typerror(state, index, TYPE_NAMES[type]);
+	return NULL;
+}
+
+TVector2<float> * checkVector2(lua_State * state, int index)
+{
+	return static_cast<TVector2<float> *>(checkType(state, index, VECTOR2));
+}
+
+TRectangle<float> * checkRectangle(lua_State * state, int index)
+{
+	return static_cast<TRectangle<float> *>(checkType(state, index,
+			RECTANGLE));
+}
+
+float * checkArray(lua_State * state, int index, size_t& outCount)
+{
+	ArrayHeader * header = static_cast<ArrayHeader *>(checkType(state, index,
+			VECTOR2_ARRAY));
+	outCount = header->count;
+	return reinterpret_cast<float *>(header + 1);
+}
+
+float checkFloat(lua_State * state, int index)
+{
+	return static_cast<float>(luaL_checknumber(state, index));
+}
+
+/**
+ * @return the position of a 1-based index in the coordinates
+ */
+size_t checkArrayIndex(lua_State * state, int index, size_t count)
+{
+	lua_Integer i = luaL_checkinteger(state, index);
+	luaL_argcheck(state, i >= 1 && static_cast<size_t>(i) <= count, index,
+			"index out of range");
+	return (static_cast<size_t>(i) - 1) * 2;
+}
+
+void * newUserData(lua_State * state, size_t size, Type type)
+{
+	void * data = lua_newuserdata(state, size);
+	lua_pushvalue(state, lua_upvalueindex(type));
+	lua_setmetatable(state, -2);
+	return data;
+}
+
+void newVector2(lua_State * state, const TVector2<float>& vector)
+{
+	new (newUserData(state, sizeof(TVector2<float>), VECTOR2))
+			TVector2<float>(vector);
+}
+
+void newRectangle(lua_State * state, const TRectangle<float>& rectangle)
+{
+	new (newUserData(state, sizeof(TRectangle<float>), RECTANGLE))
+			TRectangle<float>(rectangle);
+}
+
+/**
+ * A single character field name, '\0' for any other key
+ */
+char getFieldName(lua_State * state, int index)
+{
+	size_t length = 0;
+	const char * key = (lua_type(state, index) == LUA_TSTRING) ?
+			lua_tolstring(state, index, &length) : NULL;
+	return (length == 1) ? key[0] : '\0';
+}
+
+/**
+ * __index of the types with fields, after the fields: the methods are in
+ * the metatable.
+ */
+int indexMethod(lua_State * state)
+{
+	lua_getmetatable(state, 1);
+	lua_pushvalue(state, 2);
+	lua_rawget(state, -2);
+	return 1;
+}
+
+/**
+ * Set the functions in the table at tableIndex, with the metatables from
+ * firstType as upvalues.
+ */
+void registerFunctions(lua_State * state, int firstType, int tableIndex,
+		const luaL_Reg * functions)
+{
+	for (; functions->name != NULL; ++functions)
+	{
+		for (int type = VECTOR2; type <= VECTOR2_ARRAY; ++type)
+		{
+			lua_pushvalue(state, firstType + type - VECTOR2);
+		}
+		lua_pushcclosure(state, functions->func, VECTOR2_ARRAY);
+		lua_setfield(state, tableIndex, functions->name);
+	}
+}
+
+/*
+ * Vector2
+ */
+
+int vector2New(lua_State * state)
+{
+	newVector2(state, TVector2<float>(
+			static_cast<float>(luaL_optnumber(state, 1, 0.0)),
+			static_cast<float>(luaL_optnumber(state, 2, 0.0))));
+	return 1;
+}
+
+int vector2Index(lua_State * state)
+{
+	TVector2<float> * vector = checkVector2(state, 1);
+	switch (getFieldName(state, 2))
+	{
+		case 'x':
+			lua_pushnumber(state, vector->getX());
+			return 1;
+		case 'y':
+			lua_pushnumber(state, vector->getY());
+			return 1;
+		default:
+			return indexMethod(state);
+	}
+}
+
+int vector2NewIndex(lua_State * state)
+{
+	TVector2<float> * vector = checkVector2(state, 1);
+	switch (getFieldName(state, 2))
+	{
+		case 'x':
+			vector->setX(checkFloat(state, 3));
+			return 0;
+		case 'y':
+			vector->setY(checkFloat(state, 3));
+			return 0;
+		default:
+			return luaL_error(state, "Vector2 has no field '%s'",
+					lua_tostring(state, 2));
+	}
+}
+
+int vector2Add(lua_State * state)
+{
+	newVector2(state, *checkVector2(state, 1) + *checkVector2(state, 2));
+	return 1;
+}
+
+int vector2Sub(lua_State * state)
+{
+	newVector2(state, *checkVector2(state, 1) - *checkVector2(state, 2));
+	return 1;
+}
+
+int vector2Mul(lua_State * state)
+{
+	// the scalar can be on either side
+	if (lua_isnumber(state, 1))
+	{
+		newVector2(state, *checkVector2(state, 2) * checkFloat(state, 1));
+	}
+	else
+	{
+		newVector2(state, *checkVector2(state, 1) * checkFloat(state, 2));
+	}
+	return 1;
+}
+
+int vector2Div(lua_State * state)
+{
+	newVector2(state, *checkVector2(state, 1) / checkFloat(state, 2));
+	return 1;
+}
+
+int vector2Unm(lua_State * state)
+{
+	TVector2<float> * vector = checkVector2(state, 1);
+	newVector2(state, TVector2<float>(-vector->getX(), -vector->getY()));
+	return 1;
+}
+
+int vector2Eq(lua_State * state)
+{
+	lua_pushboolean(state, *checkVector2(state, 1) == *checkVector2(state, 2));
+	return 1;
+}
+
+int vector2ToString(lua_State * state)
+{
+	TVector2<float> * vector = checkVector2(state, 1);
+	lua_pushfstring(state, "Vector2(%f, %f)", lua_Number(vector->getX()),
+			lua_Number(vector->getY()));
+	return 1;
+}
+
+int vector2Magnitude(lua_State * state)
+{
+	lua_pushnumber(state, checkVector2(state, 1)->magnitude());
+	return 1;
+}
+
+int vector2Normalize(lua_State * state)
+{
+	lua_pushnumber(state, checkVector2(state, 1)->normalize());
+	return 1;
+}
+
+int vector2Dot(lua_State * state)
+{
+	lua_pushnumber(state,
+			checkVector2(state, 1)->dotProduct(*checkVector2(state, 2)));
+	return 1;
+}
+
+int vector2Cross(lua_State * state)
+{
+	lua_pushnumber(state,
+			checkVector2(state, 1)->crossProduct(*checkVector2(state, 2)));
+	return 1;
+}
+
+int vector2Distance(lua_State * state)
+{
+	lua_pushnumber(state,
+			checkVector2(state, 1)->distance(*checkVector2(state, 2)));
+	return 1;
+}
+
+int vector2Rotate(lua_State * state)
+{
+	newVector2(state, checkVector2(state, 1)->rotate(checkFloat(state, 2)));
+	return 1;
+}
+
+int vector2Copy(lua_State * state)
+{
+	newVector2(state, *checkVector2(state, 1));
+	return 1;
+}
+
+int vector2Unpack(lua_State * state)
+{
+	TVector2<float> * vector = checkVector2(state, 1);
+	lua_pushnumber(state, vector->getX());
+	lua_pushnumber(state, vector->getY());
+	return 2;
+}
+
+/*
+ * The in place ones return the vector itself, to chain them
+ */
+
+int vector2Set(lua_State * state)
+{
+	TVector2<float> * vector = checkVector2(state, 1);
+	vector->setX(checkFloat(state, 2));
+	vector->setY(checkFloat(state, 3));
+	lua_settop(state, 1);
+	return 1;
+}
+
+int vector2AddInPlace(lua_State * state)
+{
+	*checkVector2(state, 1) += *checkVector2(state, 2);
+	lua_settop(state, 1);
+	return 1;
+}
+
+int vector2SubInPlace(lua_State * state)
+{
+	*checkVector2(state, 1) -= *checkVector2(state, 2);
+	lua_settop(state, 1);
+	return 1;
+}
+
+int vector2ScaleInPlace(lua_State * state)
+{
+	*checkVector2(state, 1) *= checkFloat(state, 2);
+	lua_settop(state, 1);
+	return 1;
+}
+
+const luaL_Reg vector2Functions[] =
+{
+	{ "__index", vector2Index },
+	{ "__newindex", vector2NewIndex },
+	{ "__add", vector2Add },
+	{ "__sub", vector2Sub },
+	{ "__mul", vector2Mul },
+	{ "__div", vector2Div },
+	{ "__unm", vector2Unm },
+	{ "__eq", vector2Eq },
+	{ "__tostring", vector2ToString },
+	{ "magnitude", vector2Magnitude },
+	{ "normalize", vector2Normalize },
+	{ "dot", vector2Dot },
+	{ "cross", vector2Cross },
+	{ "distance", vector2Distance },
+	{ "rotate", vector2Rotate },
+	{ "copy", vector2Copy },
+	{ "unpack", vector2Unpack },
+	{ "set", vector2Set },
+	{ "add", vector2AddInPlace },
+	{ "sub", vector2SubInPlace },
+	{ "scale", vector2ScaleInPlace },
+	{ NULL, NULL }
+};
+
+/*
+ * Rectangle
+ */
+
+int rectangleNew(lua_State * state)
+{
+	newRectangle(state, TRectangle<float>(
+			static_cast<float>(luaL_optnumber(state, 1, 0.0)),
+			static_cast<float>(luaL_optnumber(state, 2, 0.0)),
+			static_cast<float>(luaL_optnumber(state, 3, 0.0)),
+			static_cast<float>(luaL_optnumber(state, 4, 0.0))));
+	return 1;
+}
+
+int rectangleIndex(lua_State * state)
+{
+	TRectangle<float> * rectangle = checkRectangle(state, 1);
+	switch (getFieldName(state, 2))
+	{
+		case 'x':
+			lua_pushnumber(state, rectangle->getX());
+			return 1;
+		case 'y':
+			lua_pushnumber(state, rectangle->getY());
+			return 1;
+		case 'w':
+			lua_pushnumber(state, rectangle->getW());
+			return 1;
+		case 'h':
+			lua_pushnumber(state, rectangle->getH());
+			return 1;
+		default:
+			return indexMethod(state);
+	}
+}
+
+int rectangleNewIndex(lua_State * state)
+{
+	TRectangle<float> * rectangle = checkRectangle(state, 1);
+	switch (getFieldName(state, 2))
+	{
+		case 'x':
+			rectangle->setX(checkFloat(state, 3));
+			return 0;
+		case 'y':
+			rectangle->setY(checkFloat(state, 3));
+			return 0;
+		case 'w':
+			rectangle->setW(checkFloat(state, 3));
+			return 0;
+		case 'h':
+			rectangle->setH(checkFloat(state, 3));
+			return 0;
+		default:
+			return luaL_error(state, "Rectangle has no field '%s'",
+					lua_tostring(state, 2));
+	}
+}
+
+int rectangleEq(lua_State * state)
+{
+	// TRectangle::operator== only compares the sizes
+	TRectangle<float> * a = checkRectangle(state, 1);
+	TRectangle<float> * b = checkRectangle(state, 2);
+	lua_pushboolean(state, a->getX() == b->getX() && a->getY() == b->getY()
+			&& a->getW() == b->getW() && a->getH() == b->getH());
+	return 1;
+}
+
+int rectangleToString(lua_State * state)
+{
+	TRectangle<float> * rectangle = checkRectangle(state, 1);
+	lua_pushfstring(state, "Rectangle(%f, %f, %f, %f)",
+			lua_Number(rectangle->getX()), lua_Number(rectangle->getY()),
+			lua_Number(rectangle->getW()), lua_Number(rectangle->getH()));
+	return 1;
+}
+
+int rectangleContains(lua_State * state)
+{
+	TRectangle<float> * rectangle = checkRectangle(state, 1);
+	if (lua_isnumber(state, 2))
+	{
+		lua_pushboolean(state,
+				rectangle->contains(checkFloat(state, 2), checkFloat(state, 3)));
+	}
+	else
+	{
+		lua_pushboolean(state, rectangle->contains(*checkVector2(state, 2)));
+	}
+	return 1;
+}
+
+int rectangleGetCenter(lua_State * state)
+{
+	newVector2(state, checkRectangle(state, 1)->getCenter());
+	return 1;
+}
+
+int rectangleGetDistance(lua_State * state)
+{
+	lua_pushnumber(state,
+			checkRectangle(state, 1)->getDistance(*checkRectangle(state, 2)));
+	return 1;
+}
+
+int rectangleGetIntersectionDepth(lua_State * state)
+{
+	newVector2(state, checkRectangle(state, 1)->getIntersectionDepth(
+			*checkRectangle(state, 2)));
+	return 1;
+}
+
+int rectangleSet(lua_State * state)
+{
+	TRectangle<float> * rectangle = checkRectangle(state, 1);
+	rectangle->setX(checkFloat(state, 2));
+	rectangle->setY(checkFloat(state, 3));
+	rectangle->setW(checkFloat(state, 4));
+	rectangle->setH(checkFloat(state, 5));
+	lua_settop(state, 1);
+	return 1;
+}
+
+int rectangleUnpack(lua_State * state)
+{
+	TRectangle<float> * rectangle = checkRectangle(state, 1);
+	lua_pushnumber(state, rectangle->getX());
+	lua_pushnumber(state, rectangle->getY());
+	lua_pushnumber(state, rectangle->getW());
+	lua_pushnumber(state, rectangle->getH());
+	return 4;
+}
+
+const luaL_Reg rectangleFunctions[] =
+{
+	{ "__index", rectangleIndex },
+	{ "__newindex", rectangleNewIndex },
+	{ "__eq", rectangleEq },
+	{ "__tostring", rectangleToString },
+	{ "contains", rectangleContains },
+	{ "getCenter", rectangleGetCenter },
+	{ "getDistance", rectangleGetDistance },
+	{ "getIntersectionDepth", rectangleGetIntersectionDepth },
+	{ "set", rectangleSet },
+	{ "unpack", rectangleUnpack },
+	{ NULL, NULL }
+};
+
+/*
+ * Vector2Array, the batch functions loop in C over the packed
+ * coordinates and return the array itself.
+ */
+
+int arrayNew(lua_State * state)
+{
+	lua_Integer count = luaL_checkinteger(state, 1);
+	luaL_argcheck(state, count >= 0, 1, "negative size");
+	// the size in bytes must not wrap around, the functions trust count
+	luaL_argcheck(state, static_cast<size_t>(count)
+			<= (SIZE_MAX - sizeof(ArrayHeader)) / (2 * sizeof(float)), 1,
+			"size too large");
+
+	size_t size = sizeof(ArrayHeader)
+			+ static_cast<size_t>(count) * 2 * sizeof(float);
+	ArrayHeader * header = static_cast<ArrayHeader *>(newUserData(state,
+			size, VECTOR2_ARRAY));
+	header->count = static_cast<size_t>(count);
+	std::memset(header + 1, 0, size - sizeof(ArrayHeader));
+	return 1;
+}
+
+int arrayLength(lua_State * state)
+{
+	size_t count;
+	checkArray(state, 1, count);
+	lua_pushinteger(state, static_cast<lua_Integer>(count));
+	return 1;
+}
+
+int arrayGet(lua_State * state)
+{
+	size_t count;
+	float * coords = checkArray(state, 1, count);
+	size_t i = checkArrayIndex(state, 2, count);
+	lua_pushnumber(state, coords[i]);
+	lua_pushnumber(state, coords[i + 1]);
+	return 2;
+}
+
+int arraySet(lua_State * state)
+{
+	size_t count;
+	float * coords = checkArray(state, 1, count);
+	size_t i = checkArrayIndex(state, 2, count);
+	coords[i] = checkFloat(state, 3);
+	coords[i + 1] = checkFloat(state, 4);
+	return 0;
+}
+
+int arrayFill(lua_State * state)
+{
+	size_t count;
+	float * coords = checkArray(state, 1, count);
+	float x = checkFloat(state, 2);
+	float y = checkFloat(state, 3);
+	for (size_t i = 0; i < count * 2; i += 2)
+	{
+		coords[i] = x;
+		coords[i + 1] = y;
+	}
+	lua_settop(state, 1);
+	return 1;
+}
+
+int arrayTranslate(lua_State * state)
+{
+	size_t count;
+	float * coords = checkArray(state, 1, count);
+	float dx;
+	float dy;
+	if (lua_isnumber(state, 2))
+	{
+		dx = checkFloat(state, 2);
+		dy = checkFloat(state, 3);
+	}
+	else
+	{
+		TVector2<float> * offset = checkVector2(state, 2);
+		dx = offset->getX();
+		dy = offset->getY();
+	}
+
+	for (size_t i = 0; i < count * 2; i += 2)
+	{
+		coords[i] += dx;
+		coords[i + 1] += dy;
+	}
+	lua_settop(state, 1);
+	return 1;
+}
+
+int arrayScale(lua_State * state)
+{
+	size_t count;
+	float * coords = checkArray(state, 1, count);
+	float sx = checkFloat(state, 2);
+	float sy = lua_isnoneornil(state, 3) ? sx : checkFloat(state, 3);
+	for (size_t i = 0; i < count * 2; i += 2)
+	{
+		coords[i] *= sx;
+		coords[i + 1] *= sy;
+	}
+	lua_settop(state, 1);
+	return 1;
+}
+
+int arrayRotate(lua_State * state)
+{
+	size_t count;
+	float * coords = checkArray(state, 1, count);
+
+	// in degrees, like TVector2::rotate(), the sine and cosine only once
+	float radians = static_cast<float>(luaL_checknumber(state, 2) * M_PI / 180);
+	float c = cosf(radians);
+	float s = sinf(radians);
+	for (size_t i = 0; i < count * 2; i += 2)
+	{
+		float x = coords[i];
+		float y = coords[i + 1];
+		coords[i] = x * c - y * s;
+		coords[i + 1] = y * c + x * s;
+	}
+	lua_settop(state, 1);
+	return 1;
+}
+
+int arrayAdd(lua_State * state)
+{
+	size_t count;
+	float * coords = checkArray(state, 1, count);
+	size_t otherCount;
+	const float * other = checkArray(state, 2, otherCount);
+	luaL_argcheck(state, otherCount == count, 2, "arrays of different sizes");
+
+	for (size_t i = 0; i < count * 2; ++i)
+	{
+		coords[i] += other[i];
+	}
+	lua_settop(state, 1);
+	return 1;
+}
+
+int arrayNormalize(lua_State * state)
+{
+	size_t count;
+	float * coords = checkArray(state, 1, count);
+	for (size_t i = 0; i < count * 2; i += 2)
+	{
+		float magnitude = sqrtf(coords[i] * coords[i]
+				+ coords[i + 1] * coords[i + 1]);
+		if (magnitude != 0.0f)
+		{
+			coords[i] /= magnitude;
+			coords[i + 1] /= magnitude;
+		}
+	}
+	lua_settop(state, 1);
+	return 1;
+}
+
+int arrayBounds(lua_State * state)
+{
+	size_t count;
+	const float * coords = checkArray(state, 1, count);
+	if (count == 0)
+	{
+		newRectangle(state, TRectangle<float>());
+		return 1;
+	}
+
+	float minX = FLT_MAX;
+	float minY = FLT_MAX;
+	float maxX = -FLT_MAX;
+	float maxY = -FLT_MAX;
+	for (size_t i = 0; i < count * 2; i += 2)
+	{
+		minX = (coords[i] < minX) ? coords[i] : minX;
+		maxX = (coords[i] > maxX) ? coords[i] : maxX;
+		minY = (coords[i + 1] < minY) ? coords[i + 1] : minY;
+		maxY = (coords[i + 1] > maxY) ? coords[i + 1] : maxY;
+	}
+	newRectangle(state, TRectangle<float>(minX, minY, maxX - minX, maxY - minY));
+	return 1;
+}
+
+int arrayCountInside(lua_State * state)
+{
+	size_t count;
+	const float * coords = checkArray(state, 1, count);
+	const TRectangle<float> * rectangle = checkRectangle(state, 2);
+
+	lua_Integer inside = 0;
+	for (size_t i = 0; i < count * 2; i += 2)
+	{
+		if (rectangle->contains(coords[i], coords[i + 1]))
+		{
+			++inside;
+		}
+	}
+	lua_pushinteger(state, inside);
+	return 1;
+}
+
+int arrayToString(lua_State * state)
+{
+	size_t count;
+	checkArray(state, 1, count);
+	lua_pushfstring(state, "Vector2Array(%d)", static_cast<int>(count));
+	return 1;
+}
+
+const luaL_Reg arrayFunctions[] =
+{
+	{ "__len", arrayLength },
+	{ "__tostring", arrayToString },
+	{ "get", arrayGet },
+	{ "set", arraySet },
+	{ "fill", arrayFill },
+	{ "translate", arrayTranslate },
+	{ "scale", arrayScale },
+	{ "rotate", arrayRotate },
+	{ "add", arrayAdd },
+	{ "normalize", arrayNormalize },
+	{ "bounds", arrayBounds },
+	{ "countInside", arrayCountInside },
+	{ NULL, NULL }
+};
+
+const luaL_Reg constructors[] =
+{
+	{ "Vector2", vector2New },
+	{ "Rectangle", rectangleNew },
+	{ "Vector2Array", arrayNew },
+	{ NULL, NULL }
+};
+
+}
+
+void openGeometry(lua_State * state)
+{
+	int first = lua_gettop(state) + 1;
+	luaL_newmetatable(state, VECTOR2_TYPE);
+	luaL_newmetatable(state, RECTANGLE_TYPE);
+	luaL_newmetatable(state, VECTOR2_ARRAY_TYPE);
+
+	registerFunctions(state, first, first, vector2Functions);
+	registerFunctions(state, first, first + 1, rectangleFunctions);
+	registerFunctions(state, first, first + 2, arrayFunctions);
+
+	// no fields in an array, the VM finds its methods by itself
+	lua_pushvalue(state, first + 2);
+	lua_setfield(state, first + 2, "__index");
+
+	registerFunctions(state, first, LUA_GLOBALSINDEX, constructors);
+	lua_settop(state, first - 1);
+}
+
+void pushVector2(lua_State * state, const TVector2<float>& vector)
+{
+	void * memory = lua_newuserdata(state, sizeof(TVector2<float>));
+	new (memory) TVector2<float>(vector);
+	luaL_getmetatable(state, VECTOR2_TYPE);
+	lua_setmetatable(state, -2);
+}
+
+void pushRectangle(lua_State * state, const TRectangle<float>& rectangle)
+{
+	void * memory = lua_newuserdata(state, sizeof(TRectangle<float>));
+	new (memory) TRectangle<float>(rectangle);
+	luaL_getmetatable(state, RECTANGLE_TYPE);
+	lua_setmetatable(state, -2);
+}
+
+namespace
+{
+
+/**
+ * luaL_checkudata() without the error
+ */
+void * toUserData(lua_State * state, int index, const char * type)
+{
+	void * data = lua_touserdata(state, index);
+	if (data == NULL || !lua_getmetatable(state, index))
+	{
+		return NULL;
+	}
+	luaL_getmetatable(state, type);
+	bool sameType = lua_rawequal(state, -1, -2) != 0;
+	lua_pop(state, 2);
+	return sameType ? data : NULL;
+}
+
+}
+
+TVector2<float> * toVector2(lua_State * state, int index)
+{
+	return static_cast<TVector2<float> *>(toUserData(state, index,
+			VECTOR2_TYPE));
+}
+
+TRectangle<float> * toRectangle(lua_State * state, int index)
+{
+	return static_cast<TRectangle<float> *>(toUserData(state, index,
+			RECTANGLE_TYPE));
+}
+
+float * toVector2Array(lua_State * state, int index, size_t& outCount)
+{
+	ArrayHeader * header = static_cast<ArrayHeader *>(toUserData(state, index,
+			VECTOR2_ARRAY_TYPE));
+	if (header == NULL)
+	{
+		return NULL;
+	}
+	outCount = header->count;
+	return reinterpret_cast<float *>(header + 1);
+}
+
+} /* namespace Util */
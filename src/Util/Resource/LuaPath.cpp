@@ -0,0 +1,139 @@
+/*
+ * @file	LuaPath.cpp
+ * @date	2026-10-19
+ * @brief	Compiled path to a value in nested Lua tables.
+ */
+
+#include "Util/Resource/LuaPath.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Util
+{
+
+LuaPath::LuaPath() :
+				mValid(false)
+{
+}
+
+LuaPath::LuaPath(const std::string& path) :
+				mValid(false)
+{
+	mValid = parse(path);
+	if (!mValid)
+	{
+		mSegments.clear();
+		mKey.clear();
+	}
+}
+
+bool LuaPath::isValid() const
+{
+	return mValid;
+}
+
+const std::string& LuaPath::getKey() const
+{
+	return mKey;
+}
+
+bool LuaPath::push(lua_State * state) const
+{
+	if (!mValid)
+	{
+		lua_pushnil(state);
+		return false;
+	}
+
+	lua_getfield(state, LUA_GLOBALSINDEX, mSegments[0].field.c_str());
+	for (size_t i = 1; i < mSegments.size(); ++i)
+	{
+		if (!lua_istable(state, -1))
+		{
+			lua_pop(state, 1);
+			lua_pushnil(state);
+			return false;
+		}
+
+		// the table is replaced by its field
+		const Segment& segment = mSegments[i];
+		if (segment.field.empty())
+		{
+			lua_rawgeti(state, -1, segment.index);
+		}
+		else
+		{
+			lua_getfield(state, -1, segment.field.c_str());
+		}
+		lua_remove(state, -2);
+	}
+	return !lua_isnil(state, -1);
+}
+
+bool LuaPath::parse(const std::string& path)
+{
+	size_t pos = 0;
+	while (pos < path.size())
+	{
+		Segment segment;
+		segment.index = 0;
+
+		if (path[pos] == '[')
+		{
+			// an index, never first
+			size_t end = path.find(']', pos);
+			if (mSegments.empty() || end == std::string::npos || end == pos + 1)
+			{
+				return false;
+			}
+			std::string number = path.substr(pos + 1, end - pos - 1);
+			char * numberEnd = NULL;
+			long index = std::strtol(number.c_str(), &numberEnd, 10);
+			if (*numberEnd != '\0')
+			{
+				return false;
+			}
+			segment.index = static_cast<int>(index);
+			pos = end + 1;
+
+			char buffer[32];
+			std::snprintf(buffer, sizeof(buffer), "[%d]", segment.index);
+			mKey += buffer;
+		}
+		else
+		{
+			// a field name, after a '.' unless first
+			if (!mSegments.empty())
+			{
+				if (path[pos] != '.')
+				{
+					return false;
+				}
+				++pos;
+			}
+			size_t end = path.find_first_of(".[", pos);
+			if (end == std::string::npos)
+			{
+				end = path.size();
+			}
+			if (end == pos)
+			{
+				return false;
+			}
+			segment.field = path.substr(pos, end - pos);
+			pos = end;
+
+			if (!mSegments.empty())
+			{
+				mKey += '.';
+			}
+			mKey += segment.field;
+		}
+		mSegments.push_back(segment);
+	}
+	return !mSegments.empty();
+}
+
+} /* namespace Util */
@@ -6,68 +6,843 @@
  */
 
 #include "Util/Resource/LuaResource.h"
+#include "Util/Resource/LuaGeometry.h"
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <utility>
 
 namespace Util
 {
 
-LuaResource::LuaResource()
+namespace
 {
-	mFile = luaL_newstate();
+
+/**
+ * lua_Writer appending the compiled chunk to a std::string
+ */
+int writeChunk(lua_State * /*state*/, const void * data, size_t size,
+		void * userData)
+{
+	static_cast<std::string *>(userData)->append(
+			static_cast<const char *>(data), size);
+	return 0;
+}
+
+/**
+ * Limits of a script running on this thread, read by the count hook
+ */
+struct ExecutionLimit
+{
+	lua_State * state;
+	int interval; /**< of the hook */
+	unsigned long instructions; /**< run so far, by intervals */
+	unsigned long maxInstructions;
+	long long maxMicroseconds;
+	std::chrono::steady_clock::time_point deadline;
+};
+
+thread_local ExecutionLimit * tCurrentLimit = NULL;
+
+/**
+ * Ids of the states, for the references kept outside
+ */
+std::atomic<unsigned long> sNextStateId(1);
+
+/**
+ * Raise a Lua error once a limit is exceeded, and again on each
+ * instruction after that, so a script catching it with pcall() doesn't
+ * get away.
+ */
+void limitHook(lua_State * state, lua_Debug * /*debug*/)
+{
+	// the coroutines created by the script have the hook too, they
+	// run on the same thread and have the same limits
+	ExecutionLimit * limit = tCurrentLimit;
+	if (limit == NULL)
+	{
+		return;
+	}
+	limit->instructions += limit->interval;
+
+	// no C++ object here, lua_error() doesn't unwind the stack
+	char message[128];
+	if (limit->maxInstructions != 0
+			&& limit->instructions >= limit->maxInstructions)
+	{
+		std::snprintf(message, sizeof(message),
+				"instruction limit of %lu exceeded", limit->maxInstructions);
+	}
+	else if (limit->maxMicroseconds != 0
+			&& std::chrono::steady_clock::now() >= limit->deadline)
+	{
+		std::snprintf(message, sizeof(message),
+				"time limit of %lld microseconds exceeded",
+				limit->maxMicroseconds);
+	}
+	else
+	{
+		return;
+	}
+
+	// checked on every instruction from now on, or a loop around a
+	// pcall() would always get the error in the function it calls
+	limit->interval = 1;
+	lua_sethook(state, limitHook, LUA_MASKCOUNT, 1);
+
+	lua_Debug where;
+	if (lua_getstack(state, 0, &where) && lua_getinfo(state, "Sl", &where)
+			&& where.currentline > 0)
+	{
+		lua_pushfstring(state, "%s:%d: %s", where.short_src,
+				where.currentline, message);
+	}
+	else
+	{
+		lua_pushstring(state, message);
+	}
+	lua_error(state);
+}
+
+/**
+ * Sets the hook for the lifetime of the scope, if there's a limit
+ */
+class LimitScope
+{
+	public:
+		LimitScope(lua_State * state, unsigned long maxInstructions,
+				long long maxMicroseconds) :
+						mActive(maxInstructions != 0 || maxMicroseconds != 0),
+						mPrevious(tCurrentLimit)
+		{
+			if (!mActive)
+			{
+				return;
+			}
+			mLimit.state = state;
+			mLimit.interval = LuaResource::HOOK_INTERVAL;
+			if (maxInstructions != 0
+					&& maxInstructions < static_cast<unsigned long>(mLimit.interval))
+			{
+				mLimit.interval = static_cast<int>(maxInstructions);
+			}
+			mLimit.instructions = 0;
+			mLimit.maxInstructions = maxInstructions;
+			mLimit.maxMicroseconds = maxMicroseconds;
+			mLimit.deadline = std::chrono::steady_clock::now()
+					+ std::chrono::microseconds(maxMicroseconds);
+
+			tCurrentLimit = &mLimit;
+			lua_sethook(state, limitHook, LUA_MASKCOUNT, mLimit.interval);
+		}
+
+		~LimitScope()
+		{
+			if (!mActive)
+			{
+				return;
+			}
+			tCurrentLimit = mPrevious;
+			// a call from a C function of a script running with limits
+			if (mPrevious != NULL && mPrevious->state == mLimit.state)
+			{
+				lua_sethook(mLimit.state, limitHook, LUA_MASKCOUNT,
+						mPrevious->interval);
+			}
+			else
+			{
+				lua_sethook(mLimit.state, NULL, 0, 0);
+			}
+		}
+
+	private:
+		LimitScope(const LimitScope&);
+		LimitScope& operator=(const LimitScope&);
+
+		bool mActive;
+		ExecutionLimit mLimit;
+		ExecutionLimit * mPrevious;
+};
+
+}
+
+bool LuaResource::sSnapshotByDefault = false;
+unsigned long LuaResource::sDefaultMaxInstructions = 0;
+long long LuaResource::sDefaultMaxMicroseconds = 0;
+const int LuaResource::HOOK_INTERVAL;
+
+LuaResource::LuaResource() :
+				mAllocator(new LuaAllocator()),
+				mFile(mAllocator->newState()),
+				mStateId(sNextStateId++),
+				mLoadCount(0),
+				mChunkRef(LUA_NOREF),
+				mSnapshotEnabled(sSnapshotByDefault),
+				mNextSubscriptionId(1),
+				mManualGC(false),
+				mMaxInstructions(sDefaultMaxInstructions),
+				mMaxMicroseconds(sDefaultMaxMicroseconds),
+				mStaging(NULL),
+				mReloadDone(false),
+				mReloadSucceeded(false)
+{
+	clearGCStats();
 }
 
 LuaResource::~LuaResource()
 {
 	close();
+	delete mAllocator;
 }
 
 bool LuaResource::load(const std::string& filename)
 {
-	lua_gc(mFile, LUA_GCSTOP, 0);
-	luaL_openlibs(mFile);
-	lua_gc(mFile, LUA_GCRESTART, 0);
+	openLibs();
 
 	// execute config file
-	int ret = luaL_dofile(mFile, filename.c_str());
-	if (ret != 0)
+	return execute(keepChunk(luaL_loadfile(mFile, filename.c_str())));
+}
+
+bool LuaResource::loadFromMemory(const char * data, size_t size)
+{
+	openLibs();
+
+	return execute(keepChunk(luaL_loadbuffer(mFile, data, size,
+			getChunkName().c_str())));
+}
+
+bool LuaResource::reload()
+{
+	if (getFilename().empty())
+	{
+		return false;
+	}
+
+	// the script may fail halfway, it runs in a state of its own
+	LuaResource staging;
+	copySettingsTo(staging);
+	if (!staging.loadCached(getFilename()))
+	{
+		mLastError = staging.mLastError;
+		return false;
+	}
+	swapState(staging);
+	notifyChanges();
+	return true;
+}
+
+bool LuaResource::reloadInBackground()
+{
+	if (mStaging != NULL || getFilename().empty())
+	{
+		return false;
+	}
+
+	mStaging = new LuaResource();
+	copySettingsTo(*mStaging);
+	mReloadDone = false;
+	mReloadSucceeded = false;
+
+	LuaResource * staging = mStaging;
+	mReloadThread = std::thread([this, staging]()
 	{
-		const char * msg = lua_tostring(mFile, -1);
-		if (msg)
+		mReloadSucceeded = staging->loadCached(staging->getFilename());
+		if (mReloadSucceeded && staging->mSnapshotEnabled)
 		{
-			std::cerr << "Error: " << msg << std::endl;
+			// the readers switch to the new values here, all at once
+			std::atomic_store(&mSnapshot, staging->getSnapshot());
 		}
-		else
+		mReloadDone.store(true, std::memory_order_release);
+	});
+	return true;
+}
+
+bool LuaResource::isReloading() const
+{
+	return mStaging != NULL;
+}
+
+bool LuaResource::commitReload(bool wait)
+{
+	if (mStaging == NULL
+			|| (!wait && !mReloadDone.load(std::memory_order_acquire)))
+	{
+		return false;
+	}
+	mReloadThread.join();
+
+	bool succeeded = mReloadSucceeded;
+	mLastError = mStaging->mLastError;
+	if (succeeded)
+	{
+		swapState(*mStaging);
+		notifyChanges();
+	}
+	// the old state is closed with it
+	delete mStaging;
+	mStaging = NULL;
+	return succeeded;
+}
+
+void LuaResource::cancelReload()
+{
+	if (mStaging == NULL)
+	{
+		return;
+	}
+	mReloadThread.join();
+	delete mStaging;
+	mStaging = NULL;
+}
+
+void LuaResource::copySettingsTo(Resource& staging) const
+{
+	Resource::copySettingsTo(staging);
+	LuaResource * luaStaging = dynamic_cast<LuaResource *>(&staging);
+	if (luaStaging != NULL)
+	{
+		luaStaging->mSnapshotEnabled = mSnapshotEnabled;
+		luaStaging->setExecutionLimits(mMaxInstructions, mMaxMicroseconds);
+	}
+}
+
+bool LuaResource::swapContent(Resource& staging)
+{
+	LuaResource * luaStaging = dynamic_cast<LuaResource *>(&staging);
+	if (luaStaging == NULL || luaStaging == this || !luaStaging->isLoaded())
+	{
+		return false;
+	}
+	mLastError = luaStaging->mLastError;
+	swapState(*luaStaging);
+	notifyChanges();
+	return true;
+}
+
+bool LuaResource::canSwapContent() const
+{
+	return true;
+}
+
+void LuaResource::swapState(LuaResource& other)
+{
+	std::swap(mAllocator, other.mAllocator);
+	std::swap(mFile, other.mFile);
+	std::swap(mStateId, other.mStateId);
+	std::swap(mLoadCount, other.mLoadCount);
+	std::swap(mChunkRef, other.mChunkRef);
+	mLibraryGlobals.swap(other.mLibraryGlobals);
+
+	std::shared_ptr<const LuaSnapshot> snapshot = other.getSnapshot();
+	std::atomic_store(&other.mSnapshot, getSnapshot());
+	std::atomic_store(&mSnapshot, snapshot);
+	setLoaded(true);
+
+	if (mManualGC && mFile)
+	{
+		lua_gc(mFile, LUA_GCSTOP, 0);
+	}
+}
+
+lua_State * LuaResource::getState() const
+{
+	return mFile;
+}
+
+int LuaResource::keepChunk(int loadStatus)
+{
+	// dumped by serialize() only, most loads are never cached
+	luaL_unref(mFile, LUA_REGISTRYINDEX, mChunkRef);
+	mChunkRef = LUA_NOREF;
+	if (loadStatus == 0)
+	{
+		lua_pushvalue(mFile, -1);
+		mChunkRef = luaL_ref(mFile, LUA_REGISTRYINDEX);
+	}
+	return loadStatus;
+}
+
+std::string LuaResource::getChunkName() const
+{
+	// '=' tells Lua to use the name as is in the error messages
+	return "=" + (getFilename().empty() ? "memory" : getFilename());
+}
+
+bool LuaResource::serialize(std::string& outData) const
+{
+	if (!mFile || mChunkRef == LUA_NOREF)
+	{
+		return false;
+	}
+	outData.clear();
+	lua_rawgeti(mFile, LUA_REGISTRYINDEX, mChunkRef);
+	bool dumped = (lua_dump(mFile, writeChunk, &outData) == 0);
+	lua_pop(mFile, 1);
+	return dumped && !outData.empty();
+}
+
+bool LuaResource::canSerialize() const
+{
+	return true;
+}
+
+bool LuaResource::deserialize(const char * data, size_t size)
+{
+	return deserializeEntry(data, size) == DESERIALIZE_LOADED;
+}
+
+Resource::DeserializeResult LuaResource::deserializeEntry(const char * data,
+		size_t size)
+{
+	// source text would be parsed, that's what the cache avoids
+	size_t signatureSize = std::strlen(LUA_SIGNATURE);
+	if (size < signatureSize
+			|| std::memcmp(data, LUA_SIGNATURE, signatureSize) != 0)
+	{
+		return DESERIALIZE_REJECTED;
+	}
+
+	openLibs();
+
+	// a chunk from another platform or Lua build fails its header check
+	if (luaL_loadbuffer(mFile, data, size, getChunkName().c_str()) != 0)
+	{
+		lua_pop(mFile, 1);
+		return DESERIALIZE_REJECTED;
+	}
+
+	// the script ran, its outcome is final
+	return execute(keepChunk(0)) ? DESERIALIZE_LOADED : DESERIALIZE_FAILED;
+}
+
+unsigned int LuaResource::getLoaderVersion() const
+{
+	return LUA_VERSION_NUM;
+}
+
+void LuaResource::openLibs()
+{
+	lua_gc(mFile, LUA_GCSTOP, 0);
+	luaL_openlibs(mFile);
+	openGeometry(mFile);
+	lua_gc(mFile, LUA_GCRESTART, 0);
+
+	// everything there before the first script isn't from a script
+	if (!mLibraryGlobals.empty())
+	{
+		return;
+	}
+	lua_pushnil(mFile);
+	while (lua_next(mFile, LUA_GLOBALSINDEX) != 0)
+	{
+		if (lua_type(mFile, -2) == LUA_TSTRING)
 		{
-			std::cerr << "Error: (error object is not a string)\n";
+			mLibraryGlobals.insert(lua_tostring(mFile, -2));
 		}
+		lua_pop(mFile, 1);
 	}
+}
 
+bool LuaResource::execute(int loadStatus)
+{
+	++mLoadCount;
+	bool success = false;
+	if (loadStatus == 0)
+	{
+		success = call(0, 0);
+	}
+	else
+	{
+		popError();
+	}
+	if (mManualGC)
+	{
+		lua_gc(mFile, LUA_GCSTOP, 0);
+	}
+
+	if (!success)
+	{
+		// the snapshot keeps the values of the last successful load, the
+		// state may hold half of the script
+		std::cerr << "Error: " << mLastError << std::endl;
+		setLoaded(false);
+		return false;
+	}
+
+	if (mSnapshotEnabled)
+	{
+		updateSnapshot();
+	}
+	setLoaded(true);
+	return true;
+}
+
+bool LuaResource::call(int argumentCount, int resultCount)
+{
+	mLastError.clear();
+	int status = 0;
+	{
+		LimitScope scope(mFile, mMaxInstructions, mMaxMicroseconds);
+		status = lua_pcall(mFile, argumentCount, resultCount, 0);
+	}
+	if (status != 0)
+	{
+		popError();
+		return false;
+	}
 	return true;
 }
 
-int LuaResource::getIntValue(const std::string& valueName)
+void LuaResource::popError()
+{
+	const char * msg = lua_tostring(mFile, -1);
+	mLastError = msg ? msg : "(error object is not a string)";
+	lua_pop(mFile, 1);
+}
+
+const std::string& LuaResource::getLastError() const
+{
+	return mLastError;
+}
+
+void LuaResource::setExecutionLimitsByDefault(unsigned long maxInstructions,
+		long long maxMicroseconds)
 {
-	int value = 0;
+	sDefaultMaxInstructions = maxInstructions;
+	sDefaultMaxMicroseconds = maxMicroseconds;
+}
+
+void LuaResource::setExecutionLimits(unsigned long maxInstructions,
+		long long maxMicroseconds)
+{
+	mMaxInstructions = maxInstructions;
+	mMaxMicroseconds = maxMicroseconds;
+}
+
+unsigned long LuaResource::getMaxInstructions() const
+{
+	return mMaxInstructions;
+}
+
+long long LuaResource::getMaxMicroseconds() const
+{
+	return mMaxMicroseconds;
+}
+
+int LuaResource::getIntValue(const std::string& valueName) const
+{
+	if (mSnapshotEnabled)
+	{
+		std::shared_ptr<const LuaSnapshot> snapshot = getSnapshot();
+		return snapshot ? snapshot->getInt(valueName) : 0;
+	}
 
 	lua_getglobal(mFile, valueName.c_str());
-	value = lua_tointeger(mFile, -1);
+	int value = lua_tointeger(mFile, -1);
+	lua_pop(mFile, 1);
 
 	return value;
 }
 
-std::string LuaResource::getStringValue(const std::string& valueName)
+std::string LuaResource::getStringValue(const std::string& valueName) const
 {
+	if (mSnapshotEnabled)
+	{
+		std::shared_ptr<const LuaSnapshot> snapshot = getSnapshot();
+		return snapshot ? snapshot->getString(valueName) : "";
+	}
+
 	std::string value = "";
 
 	lua_getglobal(mFile, valueName.c_str());
-	value = lua_tostring(mFile, -1);
+	const char * str = lua_tostring(mFile, -1);
+	if (str)
+	{
+		value = str;
+	}
+	lua_pop(mFile, 1);
+
+	return value;
+}
+
+int LuaResource::getInt(const LuaPath& path, int defaultValue) const
+{
+	if (mSnapshotEnabled)
+	{
+		std::shared_ptr<const LuaSnapshot> snapshot = getSnapshot();
+		return snapshot ?
+				snapshot->getInt(path.getKey(), defaultValue) : defaultValue;
+	}
+
+	int value = path.push(mFile) ? lua_tointeger(mFile, -1) : defaultValue;
+	lua_pop(mFile, 1);
+	return value;
+}
+
+float LuaResource::getFloat(const LuaPath& path, float defaultValue) const
+{
+	if (mSnapshotEnabled)
+	{
+		std::shared_ptr<const LuaSnapshot> snapshot = getSnapshot();
+		return snapshot ? static_cast<float>(snapshot->getNumber(
+				path.getKey(), defaultValue)) : defaultValue;
+	}
+
+	float value = path.push(mFile) ?
+			static_cast<float>(lua_tonumber(mFile, -1)) : defaultValue;
+	lua_pop(mFile, 1);
+	return value;
+}
+
+bool LuaResource::getBool(const LuaPath& path, bool defaultValue) const
+{
+	if (mSnapshotEnabled)
+	{
+		std::shared_ptr<const LuaSnapshot> snapshot = getSnapshot();
+		return snapshot ?
+				snapshot->getBool(path.getKey(), defaultValue) : defaultValue;
+	}
 
+	bool value = path.push(mFile) ? lua_toboolean(mFile, -1) != 0 : defaultValue;
+	lua_pop(mFile, 1);
 	return value;
 }
 
+std::string LuaResource::getString(const LuaPath& path,
+		const std::string& defaultValue) const
+{
+	if (mSnapshotEnabled)
+	{
+		std::shared_ptr<const LuaSnapshot> snapshot = getSnapshot();
+		return snapshot ?
+				snapshot->getString(path.getKey(), defaultValue) : defaultValue;
+	}
+
+	std::string value = defaultValue;
+	if (path.push(mFile))
+	{
+		size_t length = 0;
+		const char * str = lua_tolstring(mFile, -1, &length);
+		value = str ? std::string(str, length) : "";
+	}
+	lua_pop(mFile, 1);
+	return value;
+}
+
+void LuaResource::setSnapshotByDefault(bool enabled)
+{
+	sSnapshotByDefault = enabled;
+}
+
+void LuaResource::setSnapshotEnabled(bool enabled)
+{
+	mSnapshotEnabled = enabled;
+	if (!enabled)
+	{
+		std::atomic_store(&mSnapshot, std::shared_ptr<const LuaSnapshot>());
+	}
+	else if (isLoaded())
+	{
+		updateSnapshot();
+	}
+}
+
+bool LuaResource::isSnapshotEnabled() const
+{
+	return mSnapshotEnabled;
+}
+
+void LuaResource::updateSnapshot()
+{
+	if (!mFile)
+	{
+		return;
+	}
+
+	// built aside, the readers of the previous one keep it
+	std::shared_ptr<LuaSnapshot> snapshot = std::make_shared<LuaSnapshot>();
+	snapshot->build(mFile, mLibraryGlobals);
+	std::atomic_store(&mSnapshot, std::shared_ptr<const LuaSnapshot>(snapshot));
+	notifyChanges();
+}
+
+std::shared_ptr<const LuaSnapshot> LuaResource::getSnapshot() const
+{
+	return std::atomic_load(&mSnapshot);
+}
+
+unsigned int LuaResource::subscribe(const std::string& prefix,
+		ChangeCallback callback)
+{
+	// before adding it, the values already there aren't changes
+	if (!mSnapshotEnabled)
+	{
+		setSnapshotEnabled(true);
+	}
+
+	Subscription subscription;
+	subscription.id = mNextSubscriptionId++;
+	subscription.prefix = prefix;
+	subscription.callback = callback;
+	mSubscriptions.push_back(subscription);
+	return subscription.id;
+}
+
+void LuaResource::unsubscribe(unsigned int id)
+{
+	for (size_t i = 0; i < mSubscriptions.size(); ++i)
+	{
+		if (mSubscriptions[i].id == id)
+		{
+			mSubscriptions.erase(mSubscriptions.begin() + i);
+			return;
+		}
+	}
+}
+
+bool LuaResource::matchesPrefix(const std::string& path,
+		const std::string& prefix)
+{
+	if (path.compare(0, prefix.size(), prefix) != 0)
+	{
+		return false;
+	}
+	// a whole key, "window" isn't a prefix of "windows"
+	return prefix.empty() || path.size() == prefix.size()
+			|| path[prefix.size()] == '.' || path[prefix.size()] == '[';
+}
+
+void LuaResource::notifyChanges()
+{
+	std::shared_ptr<const LuaSnapshot> snapshot = getSnapshot();
+	// no snapshot before the first successful load
+	if (!snapshot || snapshot == mNotifiedSnapshot)
+	{
+		return;
+	}
+	std::shared_ptr<const LuaSnapshot> previous = mNotifiedSnapshot;
+	mNotifiedSnapshot = snapshot;
+	if (mSubscriptions.empty())
+	{
+		return;
+	}
+
+	std::vector<LuaChange> changes;
+	snapshot->diff(previous.get(), changes);
+
+	// a callback may subscribe or unsubscribe
+	std::vector<Subscription> subscriptions = mSubscriptions;
+	for (size_t i = 0; i < changes.size(); ++i)
+	{
+		for (size_t j = 0; j < subscriptions.size(); ++j)
+		{
+			if (matchesPrefix(changes[i].path, subscriptions[j].prefix))
+			{
+				subscriptions[j].callback(changes[i]);
+			}
+		}
+	}
+}
+
+void LuaResource::setManualGC(bool manual)
+{
+	mManualGC = manual;
+	if (mFile)
+	{
+		lua_gc(mFile, manual ? LUA_GCSTOP : LUA_GCRESTART, 0);
+	}
+}
+
+bool LuaResource::isManualGC() const
+{
+	return mManualGC;
+}
+
+bool LuaResource::stepGC(long long budgetMicroseconds)
+{
+	if (!mFile || budgetMicroseconds <= 0)
+	{
+		return false;
+	}
+
+	std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	bool cycleEnded = false;
+	long long elapsed = 0;
+	do
+	{
+		// data 0 runs a single basic step, a few KB of work
+		cycleEnded = lua_gc(mFile, LUA_GCSTEP, 0) != 0;
+		++mGCStats.stepCount;
+		elapsed = microsecondsSince(start);
+	} while (!cycleEnded && elapsed < budgetMicroseconds);
+
+	// in Lua 5.1 a step sets the threshold again, which restarts the
+	// automatic collector
+	if (mManualGC)
+	{
+		lua_gc(mFile, LUA_GCSTOP, 0);
+	}
+
+	if (cycleEnded)
+	{
+		++mGCStats.cycleCount;
+	}
+	mGCStats.totalMicroseconds += elapsed;
+	mGCStats.pauses.add(elapsed);
+	return cycleEnded;
+}
+
+LuaGCStats LuaResource::getGCStats() const
+{
+	LuaGCStats stats = mGCStats;
+	stats.heapSize = 0;
+	if (mFile)
+	{
+		stats.heapSize = static_cast<size_t>(lua_gc(mFile, LUA_GCCOUNT, 0))
+				* 1024 + lua_gc(mFile, LUA_GCCOUNTB, 0);
+	}
+	stats.peakHeapSize = mAllocator->getPeakSize();
+	stats.manual = mManualGC;
+	return stats;
+}
+
+void LuaResource::clearGCStats()
+{
+	mGCStats.heapSize = 0;
+	mGCStats.peakHeapSize = 0;
+	mGCStats.manual = false;
+	mGCStats.stepCount = 0;
+	mGCStats.cycleCount = 0;
+	mGCStats.totalMicroseconds = 0;
+	mGCStats.pauses.clear();
+}
+
+size_t LuaResource::getMemorySize() const
+{
+	return Resource::getMemorySize() + (sizeof(LuaResource) - sizeof(Resource))
+			+ sizeof(LuaAllocator) + mAllocator->getReservedSize();
+}
+
+const LuaAllocator& LuaResource::getAllocator() const
+{
+	return *mAllocator;
+}
+
 void LuaResource::close(void)
 {
-	lua_close(mFile);
+	cancelReload();
+
+	// the destructor closes too, don't close twice
+	if (mFile)
+	{
+		// the small blocks go with the arena, not one by one
+		mAllocator->beginClose();
+		lua_close(mFile);
+		mFile = NULL;
+		mChunkRef = LUA_NOREF;
+		mAllocator->releaseAll();
+	}
 }
 
 } /* namespace grg */
@@ -0,0 +1,304 @@
+/*
+ * @file	LuaSnapshot.cpp
+ * @date	2026-10-19
+ * @brief	Native copy of the values set by a Lua config script.
+ */
+
+#include "Util/Resource/LuaSnapshot.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Util
+{
+
+const int LuaSnapshot::MAX_DEPTH;
+
+LuaValue::LuaValue() :
+				type(NIL),
+				boolean(false),
+				number(0.0)
+{
+}
+
+int LuaValue::toInt() const
+{
+	return static_cast<int>(toNumber());
+}
+
+double LuaValue::toNumber() const
+{
+	if (type == NUMBER)
+	{
+		return number;
+	}
+	if (type != STRING)
+	{
+		return 0.0;
+	}
+
+	// like Lua, the whole string must be a number, spaces aside
+	const char * begin = string.c_str();
+	char * end = NULL;
+	double value = std::strtod(begin, &end);
+	if (end == begin)
+	{
+		return 0.0;
+	}
+	while (std::isspace(static_cast<unsigned char>(*end)))
+	{
+		++end;
+	}
+	return (*end == '\0') ? value : 0.0;
+}
+
+bool LuaValue::toBool() const
+{
+	return (type == BOOLEAN) ? boolean : (type != NIL);
+}
+
+std::string LuaValue::toString() const
+{
+	if (type == STRING)
+	{
+		return string;
+	}
+	if (type != NUMBER)
+	{
+		return "";
+	}
+
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), LUA_NUMBER_FMT, number);
+	return buffer;
+}
+
+bool LuaValue::operator==(const LuaValue& v2) const
+{
+	if (type != v2.type)
+	{
+		return false;
+	}
+	switch (type)
+	{
+		case BOOLEAN:
+			return boolean == v2.boolean;
+		case NUMBER:
+		case TABLE:
+			return number == v2.number;
+		case STRING:
+			return string == v2.string;
+		default:
+			return true;
+	}
+}
+
+bool LuaValue::operator!=(const LuaValue& v2) const
+{
+	return !(*this == v2);
+}
+
+LuaSnapshot::LuaSnapshot()
+{
+}
+
+void LuaSnapshot::build(lua_State * state,
+		const std::unordered_set<std::string>& ignoredGlobals)
+{
+	mValues.clear();
+	std::unordered_set<const void *> parentTables;
+
+	lua_pushnil(state);
+	while (lua_next(state, LUA_GLOBALSINDEX) != 0)
+	{
+		// lua_tolstring() on a number key would confuse lua_next()
+		if (lua_type(state, -2) == LUA_TSTRING)
+		{
+			size_t length = 0;
+			const char * name = lua_tolstring(state, -2, &length);
+			std::string path(name, length);
+			if (ignoredGlobals.find(path) == ignoredGlobals.end())
+			{
+				addValue(state, path, 0, parentTables);
+			}
+		}
+		lua_pop(state, 1);
+	}
+}
+
+const LuaValue * LuaSnapshot::find(const std::string& path) const
+{
+	ValueMap::const_iterator it = mValues.find(path);
+	return (it != mValues.end()) ? &it->second : NULL;
+}
+
+bool LuaSnapshot::has(const std::string& path) const
+{
+	return find(path) != NULL;
+}
+
+int LuaSnapshot::getInt(const std::string& path, int defaultValue) const
+{
+	const LuaValue * value = find(path);
+	return value ? value->toInt() : defaultValue;
+}
+
+double LuaSnapshot::getNumber(const std::string& path,
+		double defaultValue) const
+{
+	const LuaValue * value = find(path);
+	return value ? value->toNumber() : defaultValue;
+}
+
+bool LuaSnapshot::getBool(const std::string& path, bool defaultValue) const
+{
+	const LuaValue * value = find(path);
+	return value ? value->toBool() : defaultValue;
+}
+
+std::string LuaSnapshot::getString(const std::string& path,
+		const std::string& defaultValue) const
+{
+	const LuaValue * value = find(path);
+	return value ? value->toString() : defaultValue;
+}
+
+size_t LuaSnapshot::size() const
+{
+	return mValues.size();
+}
+
+const LuaSnapshot::ValueMap& LuaSnapshot::getValues() const
+{
+	return mValues;
+}
+
+void LuaSnapshot::diff(const LuaSnapshot * previous,
+		std::vector<LuaChange>& outChanges) const
+{
+	size_t first = outChanges.size();
+	for (ValueMap::const_iterator it = mValues.begin(); it != mValues.end();
+			++it)
+	{
+		const LuaValue * oldValue = previous ? previous->find(it->first) : NULL;
+		if (oldValue != NULL && *oldValue == it->second)
+		{
+			continue;
+		}
+		LuaChange change;
+		change.type = oldValue ? LuaChange::CHANGED : LuaChange::ADDED;
+		change.path = it->first;
+		if (oldValue)
+		{
+			change.oldValue = *oldValue;
+		}
+		change.newValue = it->second;
+		outChanges.push_back(change);
+	}
+
+	if (previous)
+	{
+		for (ValueMap::const_iterator it = previous->mValues.begin();
+				it != previous->mValues.end(); ++it)
+		{
+			if (mValues.find(it->first) == mValues.end())
+			{
+				LuaChange change;
+				change.type = LuaChange::REMOVED;
+				change.path = it->first;
+				change.oldValue = it->second;
+				outChanges.push_back(change);
+			}
+		}
+	}
+
+	// the hash tables have no order, the subscribers get a stable one
+	std::sort(outChanges.begin() + first, outChanges.end(),
+			[](const LuaChange& a, const LuaChange& b)
+			{
+				return a.path < b.path;
+			});
+}
+
+void LuaSnapshot::addValue(lua_State * state, const std::string& path,
+		int depth, std::unordered_set<const void *>& parentTables)
+{
+	LuaValue value;
+	switch (lua_type(state, -1))
+	{
+		case LUA_TBOOLEAN:
+			value.type = LuaValue::BOOLEAN;
+			value.boolean = lua_toboolean(state, -1) != 0;
+			break;
+
+		case LUA_TNUMBER:
+			value.type = LuaValue::NUMBER;
+			value.number = lua_tonumber(state, -1);
+			break;
+
+		case LUA_TSTRING:
+		{
+			size_t length = 0;
+			const char * str = lua_tolstring(state, -1, &length);
+			value.type = LuaValue::STRING;
+			value.string.assign(str, length);
+			break;
+		}
+
+		case LUA_TTABLE:
+			value.type = LuaValue::TABLE;
+			value.number = static_cast<double>(lua_objlen(state, -1));
+			break;
+
+		default:
+			return; // functions, userdata and threads stay in Lua
+	}
+	mValues[path] = value;
+
+	if (value.type != LuaValue::TABLE || depth >= MAX_DEPTH)
+	{
+		return;
+	}
+	const void * table = lua_topointer(state, -1);
+	if (!parentTables.insert(table).second)
+	{
+		return;
+	}
+
+	lua_checkstack(state, 3);
+	lua_pushnil(state);
+	while (lua_next(state, -2) != 0)
+	{
+		std::string childPath;
+		int keyType = lua_type(state, -2);
+		if (keyType == LUA_TSTRING)
+		{
+			size_t length = 0;
+			const char * key = lua_tolstring(state, -2, &length);
+			childPath = path + "." + std::string(key, length);
+		}
+		else if (keyType == LUA_TNUMBER)
+		{
+			// only the integer keys, an array index
+			lua_Number key = lua_tonumber(state, -2);
+			long index = static_cast<long>(key);
+			if (static_cast<lua_Number>(index) == key)
+			{
+				char buffer[32];
+				std::snprintf(buffer, sizeof(buffer), "[%ld]", index);
+				childPath = path + buffer;
+			}
+		}
+
+		if (!childPath.empty())
+		{
+			addValue(state, childPath, depth + 1, parentTables);
+		}
+		lua_pop(state, 1);
+	}
+	parentTables.erase(table);
+}
+
+} /* namespace Util */
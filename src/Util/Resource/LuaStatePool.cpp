@@ -0,0 +1,256 @@
+/*
+ * @file	LuaStatePool.cpp
+ * @date	2026-10-19
+ * @brief	Lua states with the same scripts, shared by worker threads.
+ */
+
+#include "Util/Resource/LuaStatePool.h"
+
+#include <memory>
+#include <new>
+#include <thread>
+
+namespace Util
+{
+
+std::atomic<unsigned int> LuaStatePool::sNextId(1);
+
+namespace
+{
+
+/**
+ * Home state of the calling thread in the last pools it used
+ */
+struct HomeState
+{
+	unsigned int poolId; /**< 0 for an unused entry */
+	unsigned int index;
+};
+
+const int HOME_STATE_COUNT = 4;
+
+}
+
+LuaStatePool::Lease::Lease() :
+				mPool(NULL),
+				mIndex(0)
+{
+}
+
+LuaStatePool::Lease::Lease(LuaStatePool * pool, unsigned int index) :
+				mPool(pool),
+				mIndex(index)
+{
+}
+
+LuaStatePool::Lease::Lease(Lease&& lease) :
+				mPool(lease.mPool),
+				mIndex(lease.mIndex)
+{
+	lease.mPool = NULL;
+}
+
+LuaStatePool::Lease& LuaStatePool::Lease::operator=(Lease&& lease)
+{
+	if (this != &lease)
+	{
+		release();
+		mPool = lease.mPool;
+		mIndex = lease.mIndex;
+		lease.mPool = NULL;
+	}
+	return *this;
+}
+
+LuaStatePool::Lease::~Lease()
+{
+	release();
+}
+
+bool LuaStatePool::Lease::isValid() const
+{
+	return mPool != NULL;
+}
+
+LuaResource& LuaStatePool::Lease::getResource() const
+{
+	return *mPool->mSlots[mIndex].resource;
+}
+
+LuaResource * LuaStatePool::Lease::operator->() const
+{
+	return mPool->mSlots[mIndex].resource;
+}
+
+void LuaStatePool::Lease::release()
+{
+	if (mPool)
+	{
+		mPool->giveBack(mIndex);
+		mPool = NULL;
+	}
+}
+
+LuaStatePool::LuaStatePool(unsigned int stateCount) :
+				mSlots(NULL),
+				mSlotStorage(NULL),
+				mStateCount(stateCount),
+				mNextHome(0),
+				mMissCount(0),
+				mWaiting(0),
+				mId(sNextId++)
+{
+	if (mStateCount == 0)
+	{
+		mStateCount = std::thread::hardware_concurrency();
+		if (mStateCount == 0)
+		{
+			mStateCount = 1;
+		}
+	}
+
+	// new only aligns on the fundamental alignment before C++17
+	size_t size = mStateCount * sizeof(Slot);
+	size_t space = size + alignof(Slot);
+	mSlotStorage = new char[space];
+	void * aligned = mSlotStorage;
+	mSlots = static_cast<Slot *>(std::align(alignof(Slot), size, aligned,
+			space));
+	for (unsigned int i = 0; i < mStateCount; ++i)
+	{
+		new (&mSlots[i]) Slot();
+		mSlots[i].resource = new LuaResource();
+		mSlots[i].busy = false;
+	}
+}
+
+LuaStatePool::~LuaStatePool()
+{
+	for (unsigned int i = 0; i < mStateCount; ++i)
+	{
+		delete mSlots[i].resource;
+		mSlots[i].~Slot();
+	}
+	delete[] mSlotStorage;
+}
+
+bool LuaStatePool::load(const std::string& filename)
+{
+	return copyToOthers(mSlots[0].resource->load(filename));
+}
+
+bool LuaStatePool::loadFromMemory(const char * data, size_t size)
+{
+	return copyToOthers(mSlots[0].resource->loadFromMemory(data, size));
+}
+
+LuaStatePool::Lease LuaStatePool::acquire()
+{
+	unsigned int index = tryTake();
+	if (index == mStateCount)
+	{
+		// giveBack() only notifies when someone is waiting
+		std::unique_lock<std::mutex> lock(mMutex);
+		++mWaiting;
+		while ((index = tryTake()) == mStateCount)
+		{
+			mFreed.wait(lock);
+		}
+		--mWaiting;
+	}
+	return Lease(this, index);
+}
+
+LuaStatePool::Lease LuaStatePool::tryAcquire()
+{
+	unsigned int index = tryTake();
+	return (index == mStateCount) ? Lease() : Lease(this, index);
+}
+
+unsigned int LuaStatePool::getStateCount() const
+{
+	return mStateCount;
+}
+
+unsigned long LuaStatePool::getMissCount() const
+{
+	return mMissCount;
+}
+
+bool LuaStatePool::copyToOthers(bool loaded)
+{
+	if (!loaded)
+	{
+		return false;
+	}
+
+	std::string chunk;
+	if (!mSlots[0].resource->serialize(chunk))
+	{
+		return false;
+	}
+
+	bool success = true;
+	for (unsigned int i = 1; i < mStateCount; ++i)
+	{
+		if (!mSlots[i].resource->deserialize(chunk.data(), chunk.size()))
+		{
+			success = false;
+		}
+	}
+	return success;
+}
+
+unsigned int LuaStatePool::tryTake()
+{
+	unsigned int home = getHomeIndex();
+	if (!mSlots[home].busy.exchange(true))
+	{
+		return home;
+	}
+
+	// look at the others before writing, they're another thread's home
+	for (unsigned int i = 1; i < mStateCount; ++i)
+	{
+		unsigned int index = (home + i) % mStateCount;
+		if (!mSlots[index].busy.load() && !mSlots[index].busy.exchange(true))
+		{
+			++mMissCount;
+			return index;
+		}
+	}
+	return mStateCount;
+}
+
+void LuaStatePool::giveBack(unsigned int index)
+{
+	mSlots[index].busy = false;
+	if (mWaiting > 0)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFreed.notify_one();
+	}
+}
+
+unsigned int LuaStatePool::getHomeIndex()
+{
+	static thread_local HomeState homes[HOME_STATE_COUNT];
+	static thread_local int nextHome = 0;
+
+	for (int i = 0; i < HOME_STATE_COUNT; ++i)
+	{
+		if (homes[i].poolId == mId)
+		{
+			return homes[i].index;
+		}
+	}
+
+	// the threads get the states in turn
+	HomeState& home = homes[nextHome];
+	nextHome = (nextHome + 1) % HOME_STATE_COUNT;
+	home.poolId = mId;
+	home.index = mNextHome++ % mStateCount;
+	return home.index;
+}
+
+} /* namespace Util */
@@ -11,19 +11,72 @@
  */
 
 #include "Util/Resource/Resource.h"
+#include "Util/Resource/ResourceCache.h"
+#include <ios>
 
 namespace Util {
 
 Resource::Resource() :
 				mFilename(),
-				mLoaded(false) {
+				mLoaded(false),
+				mCache(NULL) {
 }
 
 Resource::~Resource() {
 }
 
+bool Resource::loadFromMemory(const char * /*data*/, size_t /*size*/) {
+	return false;
+}
+
+bool Resource::loadFromStream(std::istream& stream) {
+	std::string data;
+	if (!readStream(stream, data)) {
+		return false;
+	}
+	return loadFromMemory(data.data(), data.size());
+}
+
 bool Resource::reload() {
-	return (getFilename() != "") ? load(getFilename()) : false;
+	return (getFilename() != "") ? loadCached(getFilename()) : false;
+}
+
+void Resource::copySettingsTo(Resource& staging) const {
+	staging.setFilename(getFilename());
+	staging.setCache(mCache);
+}
+
+bool Resource::swapContent(Resource& /*staging*/) {
+	return false;
+}
+
+bool Resource::canSwapContent() const {
+	return false;
+}
+
+size_t Resource::getMemorySize() const {
+	return sizeof(Resource) + mFilename.capacity();
+}
+
+bool Resource::serialize(std::string& /*outData*/) const {
+	return false;
+}
+
+bool Resource::canSerialize() const {
+	return false;
+}
+
+bool Resource::deserialize(const char * /*data*/, size_t /*size*/) {
+	return false;
+}
+
+Resource::DeserializeResult Resource::deserializeEntry(const char * data,
+		size_t size) {
+	return deserialize(data, size) ? DESERIALIZE_LOADED : DESERIALIZE_REJECTED;
+}
+
+unsigned int Resource::getLoaderVersion() const {
+	return 1;
 }
 
 std::string Resource::getFilename() const {
@@ -38,9 +91,52 @@ bool Resource::isLoaded() const {
 	return mLoaded;
 }
 
+void Resource::setCache(ResourceCache * cache) {
+	mCache = cache;
+}
+
+ResourceCache * Resource::getCache() const {
+	return mCache;
+}
+
 void Resource::setLoaded(bool loaded) {
 	mLoaded = loaded;
 }
 
+bool Resource::readStream(std::istream& stream, std::string& outData) {
+	outData.clear();
+
+	// size the buffer once when the stream can tell what's left
+	size_t expected = 0;
+	std::streampos start = stream.tellg();
+	if (start != std::streampos(-1)) {
+		stream.seekg(0, std::ios::end);
+		std::streampos end = stream.tellg();
+		stream.seekg(start);
+		if (stream && end != std::streampos(-1) && end > start) {
+			expected = static_cast<size_t>(end - start);
+		}
+		if (!stream.bad()) {
+			stream.clear();
+		}
+	}
+	if (expected > 0) {
+		outData.resize(expected);
+		stream.read(&outData[0], static_cast<std::streamsize>(expected));
+		outData.resize(static_cast<size_t>(stream.gcount()));
+	}
+
+	// the rest, or everything when the size isn't known
+	char chunk[16384];
+	while (stream.read(chunk, sizeof(chunk)) || stream.gcount() > 0) {
+		outData.append(chunk, static_cast<size_t>(stream.gcount()));
+	}
+	return !stream.bad();
+}
+
+bool Resource::loadCached(const std::string& filename) {
+	return mCache ? mCache->load(*this, filename) : load(filename);
+}
+
 }
 
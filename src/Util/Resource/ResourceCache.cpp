@@ -0,0 +1,182 @@
+/*
+ * @file	ResourceCache.cpp
+ * @date	2026-10-19
+ * @brief	Persistent on-disk cache of processed resources.
+ */
+
+#include "Util/Resource/ResourceCache.h"
+#include "Util/MappedFile.h"
+#include "Util/FileHelper.h"
+#include "Util/Hash.h"
+
+#include <cstring>
+#include <typeinfo>
+
+namespace Util
+{
+
+namespace
+{
+
+/**
+ * Entry layout, in native byte order since the cache is local:
+ *  magic, format version, loader version, key length, payload size,
+ *  content hash, key (type name and source path), payload.
+ */
+const char ENTRY_MAGIC[4] = { 'P', 'R', 'C', 'E' };
+const unsigned int ENTRY_FORMAT_VERSION = 1;
+const size_t ENTRY_HEADER_SIZE = 4 + 4 + 4 + 4 + 8 + 8;
+
+template<typename V>
+void appendValue(std::string& out, V value)
+{
+	out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template<typename V>
+V readValue(const char * data)
+{
+	V value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+}
+
+ResourceCache::ResourceCache(const std::string& directory) :
+				mDirectory(directory),
+				mHitCount(0),
+				mMissCount(0)
+{
+	makeDirectory(mDirectory);
+}
+
+ResourceCache::~ResourceCache()
+{
+}
+
+bool ResourceCache::load(Resource& resource, const std::string& filename)
+{
+	// neither an entry to read nor one to write
+	if (!resource.canSerialize())
+	{
+		return resource.load(filename);
+	}
+
+	// the source is hashed to detect changes, it's far cheaper than parsing
+	MappedFile source;
+	if (!source.open(filename))
+	{
+		++mMissCount;
+		return resource.load(filename);
+	}
+	unsigned long long contentHash = hashFnv1a(source.getData(),
+			source.getSize());
+	source.close();
+
+	std::string key = std::string(typeid(resource).name()) + "|" + filename;
+	std::string entryFilename = getEntryFilename(resource, filename);
+
+	Resource::DeserializeResult result = fetch(resource, entryFilename, key,
+			contentHash);
+	if (result != Resource::DESERIALIZE_REJECTED)
+	{
+		// a failure after the entry was used is the outcome of the load
+		++mHitCount;
+		return result == Resource::DESERIALIZE_LOADED;
+	}
+
+	++mMissCount;
+	if (!resource.load(filename))
+	{
+		return false;
+	}
+	store(resource, entryFilename, key, contentHash);
+	return true;
+}
+
+std::string ResourceCache::getEntryFilename(const Resource& resource,
+		const std::string& filename) const
+{
+	unsigned long long keyHash = hashFnv1a(typeid(resource).name());
+	keyHash = hashFnv1a(filename, keyHash);
+	return mDirectory + "/" + hashToHex(keyHash) + ".cache";
+}
+
+const std::string& ResourceCache::getDirectory() const
+{
+	return mDirectory;
+}
+
+unsigned long ResourceCache::getHitCount() const
+{
+	return mHitCount;
+}
+
+unsigned long ResourceCache::getMissCount() const
+{
+	return mMissCount;
+}
+
+Resource::DeserializeResult ResourceCache::fetch(Resource& resource,
+		const std::string& entryFilename, const std::string& key,
+		unsigned long long contentHash)
+{
+	MappedFile entry;
+	if (!entry.open(entryFilename) || entry.getSize() < ENTRY_HEADER_SIZE)
+	{
+		return Resource::DESERIALIZE_REJECTED;
+	}
+
+	const char * data = entry.getData();
+	if (std::memcmp(data, ENTRY_MAGIC, 4) != 0
+			|| readValue<unsigned int>(data + 4) != ENTRY_FORMAT_VERSION
+			|| readValue<unsigned int>(data + 8) != resource.getLoaderVersion())
+	{
+		return Resource::DESERIALIZE_REJECTED;
+	}
+
+	unsigned int keySize = readValue<unsigned int>(data + 12);
+	unsigned long long payloadSize = readValue<unsigned long long>(data + 16);
+	if (readValue<unsigned long long>(data + 24) != contentHash
+			|| ENTRY_HEADER_SIZE + keySize + payloadSize != entry.getSize())
+	{
+		return Resource::DESERIALIZE_REJECTED;
+	}
+
+	// different keys can share the same entry file if their hash collide
+	const char * entryKey = data + ENTRY_HEADER_SIZE;
+	if (keySize != key.size() || std::memcmp(entryKey, key.data(), keySize) != 0)
+	{
+		return Resource::DESERIALIZE_REJECTED;
+	}
+
+	return resource.deserializeEntry(entryKey + keySize,
+			static_cast<size_t>(payloadSize));
+}
+
+void ResourceCache::store(const Resource& resource,
+		const std::string& entryFilename, const std::string& key,
+		unsigned long long contentHash)
+{
+	std::string payload;
+	if (!resource.serialize(payload))
+	{
+		return; // this resource type isn't cached
+	}
+
+	std::string entry;
+	entry.reserve(ENTRY_HEADER_SIZE + key.size() + payload.size());
+	entry.append(ENTRY_MAGIC, 4);
+	appendValue(entry, ENTRY_FORMAT_VERSION);
+	appendValue(entry, resource.getLoaderVersion());
+	appendValue(entry, static_cast<unsigned int>(key.size()));
+	appendValue(entry, static_cast<unsigned long long>(payload.size()));
+	appendValue(entry, contentHash);
+	entry += key;
+	entry += payload;
+
+	writeFile(entryFilename, entry.data(), entry.size());
+}
+
+} /* namespace Util */
@@ -0,0 +1,82 @@
+/**
+ *  @file		ResourceStats.cpp
+ *  @brief     	Reports given by the TResourceManager.
+ *  @date      	2026-10-19
+ *  @copyright 	Prismal Studio 2008-2013 www.prismalstudio.com
+ */
+
+#include "Util/Resource/ResourceStats.h"
+
+namespace Util {
+
+LatencyHistogram::LatencyHistogram() {
+	clear();
+}
+
+void LatencyHistogram::add(long long microseconds) {
+	if (microseconds < 0) {
+		microseconds = 0;
+	}
+
+	// index of the highest bit set
+	int bucket = 0;
+	unsigned long long value = static_cast<unsigned long long>(microseconds);
+	while ((value >>= 1) != 0 && bucket < BUCKET_COUNT - 1) {
+		++bucket;
+	}
+
+	++mBuckets[bucket];
+	++mCount;
+	mTotal += microseconds;
+	if (microseconds > mMax) {
+		mMax = microseconds;
+	}
+}
+
+void LatencyHistogram::clear() {
+	for (int i = 0; i < BUCKET_COUNT; ++i) {
+		mBuckets[i] = 0;
+	}
+	mCount = 0;
+	mTotal = 0;
+	mMax = 0;
+}
+
+unsigned long LatencyHistogram::getCount() const {
+	return mCount;
+}
+
+unsigned long LatencyHistogram::getBucket(int bucket) const {
+	return (bucket >= 0 && bucket < BUCKET_COUNT) ? mBuckets[bucket] : 0;
+}
+
+long long LatencyHistogram::getMax() const {
+	return mMax;
+}
+
+double LatencyHistogram::getAverage() const {
+	return (mCount > 0) ? static_cast<double>(mTotal) / mCount : 0.0;
+}
+
+long long LatencyHistogram::getPercentile(double ratio) const {
+	if (mCount == 0) {
+		return 0;
+	}
+
+	unsigned long target = static_cast<unsigned long>(ratio * mCount);
+	if (target >= mCount) {
+		target = mCount - 1;
+	}
+
+	unsigned long seen = 0;
+	for (int i = 0; i < BUCKET_COUNT; ++i) {
+		seen += mBuckets[i];
+		if (seen > target) {
+			long long upper = (2LL << i) - 1;
+			return (upper < mMax) ? upper : mMax;
+		}
+	}
+	return mMax;
+}
+
+} // namespace Util
@@ -6,25 +6,849 @@
  */
 
 #include "Util/Resource/TextResource.h"
+#include "Util/TextScan.h"
+#include "Util/Compression.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <utility>
 
 namespace Util
 {
 
-TextResource::TextResource()
+const size_t TextResource::DEFAULT_BLOCK_SIZE;
+bool TextResource::sCompressionByDefault = false;
+size_t TextResource::sDefaultBlockSize = TextResource::DEFAULT_BLOCK_SIZE;
+
+namespace
+{
+
+/**
+ * Content ids start at 1, 0 marks an empty cache entry
+ */
+std::atomic<unsigned long> sNextContentId(1);
+
+/**
+ * Remove the line break from the end of a line
+ */
+size_t trimLineEnd(const char * text, size_t begin, size_t end)
+{
+	if (end > begin && text[end - 1] == '\n')
+	{
+		--end;
+	}
+	if (end > begin && text[end - 1] == '\r')
+	{
+		--end;
+	}
+	return end;
+}
+
+}
+
+/**
+ * A decompressed block and its line starts, relative to the block
+ */
+struct TextResource::CachedBlock
+{
+	unsigned long contentId;
+	size_t block;
+	unsigned long lastUse;
+	std::string text;
+	std::vector<size_t> lineStarts;
+};
+
+namespace
 {
-	// TODO Auto-generated constructor stub
 
+/**
+ * Number of decompressed blocks kept by each thread
+ */
+const int CACHED_BLOCK_COUNT = 4;
+
+}
+
+TextResource::TextResource() :
+				mText(NULL),
+				mSize(0),
+				mLineIndexBuilt(false),
+				mCompression(sCompressionByDefault),
+				mBlockSize(sDefaultBlockSize),
+				mCompressed(false),
+				mLineCount(0),
+				mContentId(0),
+				mEdit(NULL)
+{
 }
 
 TextResource::~TextResource()
 {
-	// TODO Auto-generated destructor stub
+	delete mEdit;
 }
 
 bool TextResource::load(const std::string& filename)
 {
-	// FIXME
+	// the current text stays until the new one is there
+	MappedFile file;
+	if (!file.open(filename))
+	{
+		return false;
+	}
+	close();
+	mMappedFile.swap(file);
+
+	mText = mMappedFile.getData();
+	mSize = mMappedFile.getSize();
+	if (mCompression)
+	{
+		compress();
+	}
+	setLoaded(true);
+	return true;
+}
+
+bool TextResource::loadFromMemory(const char * data, size_t size)
+{
+	// data may be in the current text, it's released last
+	if (mCompression)
+	{
+		compress(data, size);
+		return true;
+	}
+	std::string text(data, size);
+	takeText(text);
+	return true;
+}
+
+bool TextResource::loadFromStream(std::istream& stream)
+{
+	std::string text;
+	if (!readStream(stream, text))
+	{
+		return false;
+	}
+	takeText(text);
+	return true;
+}
+
+size_t TextResource::getMemorySize() const
+{
+	// a mapped file counts, its pages are resident once read
+	return Resource::getMemorySize() + (sizeof(TextResource) - sizeof(Resource))
+			+ mMappedFile.getSize() + mOwnedText.capacity()
+			+ mLineStarts.capacity() * sizeof(size_t)
+			+ mCompressedData.capacity() + mBlocks.capacity() * sizeof(Block);
+}
+
+void TextResource::copySettingsTo(Resource& staging) const
+{
+	Resource::copySettingsTo(staging);
+	TextResource * textStaging = dynamic_cast<TextResource *>(&staging);
+	if (textStaging != NULL)
+	{
+		textStaging->mCompression = mCompression;
+		textStaging->mBlockSize = mBlockSize;
+	}
+}
+
+bool TextResource::swapContent(Resource& staging)
+{
+	TextResource * other = dynamic_cast<TextResource *>(&staging);
+	if (other == NULL || other == this || !other->isLoaded())
+	{
+		return false;
+	}
+
+	// the edits point in the text
+	cancelEdit();
+	other->cancelEdit();
+
+	mMappedFile.swap(other->mMappedFile);
+	mOwnedText.swap(other->mOwnedText);
+	std::swap(mText, other->mText);
+	std::swap(mSize, other->mSize);
+	mLineStarts.swap(other->mLineStarts);
+	std::swap(mLineIndexBuilt, other->mLineIndexBuilt);
+	std::swap(mCompressed, other->mCompressed);
+	mBlocks.swap(other->mBlocks);
+	mCompressedData.swap(other->mCompressedData);
+	std::swap(mLineCount, other->mLineCount);
+	std::swap(mContentId, other->mContentId);
+
+	// a short std::string keeps its characters inside the object
+	if (mText != NULL && !mMappedFile.isOpen())
+	{
+		mText = mOwnedText.data();
+	}
+	if (other->mText != NULL && !other->mMappedFile.isOpen())
+	{
+		other->mText = other->mOwnedText.data();
+	}
+	setLoaded(true);
 	return true;
 }
 
+bool TextResource::canSwapContent() const
+{
+	return true;
+}
+
+bool TextResource::serialize(std::string& outData) const
+{
+	if (!mCompressed)
+	{
+		return false;
+	}
+
+	// sizes, block table, then the compressed data
+	size_t header[3] = { mSize, mLineCount, mBlocks.size() };
+	outData.assign(reinterpret_cast<const char *>(header), sizeof(header));
+	if (!mBlocks.empty())
+	{
+		outData.append(reinterpret_cast<const char *>(&mBlocks[0]),
+				mBlocks.size() * sizeof(Block));
+	}
+	outData += mCompressedData;
+	return true;
+}
+
+bool TextResource::canSerialize() const
+{
+	return mCompression;
+}
+
+bool TextResource::deserialize(const char * data, size_t size)
+{
+	size_t header[3];
+	if (size < sizeof(header))
+	{
+		return false;
+	}
+	std::memcpy(header, data, sizeof(header));
+
+	size_t tableSize = header[2] * sizeof(Block);
+	if (header[2] > size / sizeof(Block) || sizeof(header) + tableSize > size)
+	{
+		return false;
+	}
+
+	close();
+	mBlocks.resize(header[2]);
+	if (!mBlocks.empty())
+	{
+		std::memcpy(&mBlocks[0], data + sizeof(header), tableSize);
+	}
+	mCompressedData.assign(data + sizeof(header) + tableSize,
+			size - sizeof(header) - tableSize);
+	mSize = header[0];
+	mLineCount = header[1];
+	mCompressed = true;
+	mContentId = sNextContentId++;
+
+	// don't trust the table blindly, it is read from a file
+	if (!checkBlocks())
+	{
+		close();
+		return false;
+	}
+	setLoaded(true);
+
+	// the entry is compressed whatever this resource is set to
+	if (!mCompression)
+	{
+		decompress();
+	}
+	return true;
+}
+
+void TextResource::close()
+{
+	// the edit points in the text
+	cancelEdit();
+	mMappedFile.close();
+	std::string().swap(mOwnedText);
+	std::vector<size_t>().swap(mLineStarts);
+	mText = NULL;
+	mSize = 0;
+	mLineIndexBuilt = false;
+
+	std::vector<Block>().swap(mBlocks);
+	std::string().swap(mCompressedData);
+	mCompressed = false;
+	mLineCount = 0;
+	setLoaded(false);
+}
+
+void TextResource::setCompressionByDefault(bool enabled, size_t blockSize)
+{
+	sCompressionByDefault = enabled;
+	sDefaultBlockSize = blockSize;
+}
+
+void TextResource::setCompression(bool enabled, size_t blockSize)
+{
+	bool blockSizeChanged = (blockSize != mBlockSize);
+	mCompression = enabled;
+	mBlockSize = blockSize;
+
+	if (mCompressed && (!enabled || blockSizeChanged))
+	{
+		// compresses again with the new block size if still enabled
+		decompress();
+	}
+	else if (enabled && !mCompressed && isLoaded())
+	{
+		compress();
+	}
+}
+
+bool TextResource::isCompressed() const
+{
+	return mCompressed;
+}
+
+size_t TextResource::getCompressedSize() const
+{
+	return mCompressed ? mCompressedData.size() : 0;
+}
+
+TextView TextResource::getText() const
+{
+	if (mCompressed)
+	{
+		return TextView();
+	}
+	return TextView(mText, mSize);
+}
+
+size_t TextResource::getSize() const
+{
+	return mSize;
+}
+
+void TextResource::copyText(std::string& outText) const
+{
+	if (!mCompressed)
+	{
+		outText.assign(mText, mSize);
+		return;
+	}
+
+	outText.resize(mSize);
+	for (size_t b = 0; b < mBlocks.size(); ++b)
+	{
+		decompressBlock(b, &outText[mBlocks[b].offset]);
+	}
+}
+
+void TextResource::buildLineIndex() const
+{
+	// the blocks know their lines
+	if (mLineIndexBuilt || mCompressed)
+	{
+		return;
+	}
+
+	// count first to allocate the index only once
+	size_t newlineCount = countByte(mText, mSize, '\n');
+	mLineStarts.clear();
+	mLineStarts.reserve(newlineCount + 1);
+
+	if (mSize > 0)
+	{
+		mLineStarts.push_back(0);
+		findByte(mText, mSize, '\n', mLineStarts, 1);
+
+		// a line break at the very end doesn't start another line
+		if (mLineStarts.back() == mSize)
+		{
+			mLineStarts.pop_back();
+		}
+	}
+	mLineIndexBuilt = true;
+}
+
+bool TextResource::isLineIndexBuilt() const
+{
+	return mLineIndexBuilt || mCompressed;
+}
+
+size_t TextResource::getLineCount() const
+{
+	if (mCompressed)
+	{
+		return mLineCount;
+	}
+	buildLineIndex();
+	return mLineStarts.size();
+}
+
+TextView TextResource::getLine(size_t line) const
+{
+	return getLines(line, 1);
+}
+
+TextView TextResource::getLines(size_t first, size_t count) const
+{
+	size_t lineCount = getLineCount();
+	if (first >= lineCount || count == 0)
+	{
+		return TextView();
+	}
+	size_t last = std::min(first + count, lineCount) - 1;
+
+	if (!mCompressed)
+	{
+		size_t begin = mLineStarts[first];
+		return TextView(mText + begin, getLineEnd(last) - begin);
+	}
+
+	size_t firstBlock = findBlockOfLine(first);
+	size_t lastBlock = findBlockOfLine(last);
+	const char * text;
+	size_t begin;
+	size_t end;
+	if (firstBlock == lastBlock)
+	{
+		const CachedBlock& cached = getCachedBlock(firstBlock);
+		const std::vector<size_t>& starts = cached.lineStarts;
+		size_t firstInBlock = first - mBlocks[firstBlock].firstLine;
+		size_t lastInBlock = last - mBlocks[firstBlock].firstLine;
+
+		text = cached.text.data();
+		begin = starts[firstInBlock];
+		end = (lastInBlock + 1 < starts.size()) ?
+				starts[lastInBlock + 1] : cached.text.size();
+	}
+	else
+	{
+		// decompress the whole range in the scratch buffer of the thread
+		size_t rangeBegin = mBlocks[firstBlock].offset;
+		size_t rangeEnd = mBlocks[lastBlock].offset + mBlocks[lastBlock].size;
+
+		static thread_local std::string scratch;
+		scratch.resize(rangeEnd - rangeBegin);
+		for (size_t b = firstBlock; b <= lastBlock; ++b)
+		{
+			decompressBlock(b, &scratch[mBlocks[b].offset - rangeBegin]);
+		}
+
+		text = scratch.data();
+		begin = getLineOffset(first) - rangeBegin;
+		end = (last + 1 < lineCount) ?
+				getLineOffset(last + 1) - rangeBegin : scratch.size();
+	}
+	return TextView(text + begin, trimLineEnd(text, begin, end) - begin);
+}
+
+size_t TextResource::getLineOffset(size_t line) const
+{
+	if (!mCompressed)
+	{
+		buildLineIndex();
+		return (line < mLineStarts.size()) ? mLineStarts[line] : mSize;
+	}
+
+	if (line >= mLineCount)
+	{
+		return mSize;
+	}
+	size_t block = findBlockOfLine(line);
+	const CachedBlock& cached = getCachedBlock(block);
+	return mBlocks[block].offset
+			+ cached.lineStarts[line - mBlocks[block].firstLine];
+}
+
+size_t TextResource::getLineOfOffset(size_t offset) const
+{
+	if (!mCompressed)
+	{
+		buildLineIndex();
+		if (mLineStarts.empty())
+		{
+			return 0;
+		}
+
+		// last line start that is <= offset
+		std::vector<size_t>::const_iterator pos = std::upper_bound(
+				mLineStarts.begin(), mLineStarts.end(), offset);
+		return (pos - mLineStarts.begin()) - 1;
+	}
+
+	if (mBlocks.empty())
+	{
+		return 0;
+	}
+	size_t block = findBlockOfOffset(offset);
+	const CachedBlock& cached = getCachedBlock(block);
+	std::vector<size_t>::const_iterator pos = std::upper_bound(
+			cached.lineStarts.begin(), cached.lineStarts.end(),
+			offset - mBlocks[block].offset);
+	return mBlocks[block].firstLine + (pos - cached.lineStarts.begin()) - 1;
+}
+
+size_t TextResource::find(TextView pattern,
+		std::vector<TextMatch>& outMatches) const
+{
+	std::vector<size_t> offsets;
+	if (!mCompressed)
+	{
+		findAll(getText(), pattern, offsets);
+	}
+	else if (!pattern.empty())
+	{
+		// each block is searched with the end of the previous one in
+		// front of it, for the matches across two blocks
+		size_t overlap = pattern.size() - 1;
+		std::string buffer;
+		for (size_t b = 0; b < mBlocks.size(); ++b)
+		{
+			size_t kept = std::min(overlap, buffer.size());
+			buffer.erase(0, buffer.size() - kept);
+			buffer.resize(kept + mBlocks[b].size);
+			decompressBlock(b, &buffer[kept]);
+
+			std::vector<size_t> blockOffsets;
+			findAll(TextView(buffer), pattern, blockOffsets);
+			for (size_t i = 0; i < blockOffsets.size(); ++i)
+			{
+				offsets.push_back(mBlocks[b].offset - kept + blockOffsets[i]);
+			}
+		}
+	}
+
+	size_t first = outMatches.size();
+	for (size_t i = 0; i < offsets.size(); ++i)
+	{
+		TextMatch match;
+		match.offset = offsets[i];
+		match.length = pattern.size();
+		match.pattern = 0;
+		match.line = 0;
+		outMatches.push_back(match);
+	}
+	setMatchLines(outMatches, first);
+	return outMatches.size() - first;
+}
+
+size_t TextResource::find(const TextPatternSet& patterns,
+		std::vector<TextMatch>& outMatches) const
+{
+	size_t first = outMatches.size();
+	if (!mCompressed)
+	{
+		patterns.findAll(getText(), outMatches);
+	}
+	else
+	{
+		// the automaton state carries the matches across blocks
+		unsigned int state = 0;
+		std::string buffer;
+		for (size_t b = 0; b < mBlocks.size(); ++b)
+		{
+			buffer.resize(mBlocks[b].size);
+			decompressBlock(b, &buffer[0]);
+			state = patterns.scan(TextView(buffer), mBlocks[b].offset, state,
+					outMatches);
+		}
+	}
+	setMatchLines(outMatches, first);
+	return outMatches.size() - first;
+}
+
+TextPieceTable& TextResource::edit()
+{
+	if (mEdit == NULL)
+	{
+		if (mCompressed)
+		{
+			// the pieces need the whole text, compressed again by applyEdit()
+			std::string text;
+			copyText(text);
+			bool compression = mCompression;
+			mCompression = false;
+			takeText(text);
+			mCompression = compression;
+		}
+		mEdit = new TextPieceTable(getText());
+	}
+	return *mEdit;
+}
+
+bool TextResource::isEditing() const
+{
+	return mEdit != NULL;
+}
+
+void TextResource::applyEdit()
+{
+	if (mEdit == NULL)
+	{
+		return;
+	}
+
+	std::string text;
+	mEdit->copyText(text);
+	takeText(text);
+}
+
+void TextResource::cancelEdit()
+{
+	delete mEdit;
+	mEdit = NULL;
+}
+
+void TextResource::setMatchLines(std::vector<TextMatch>& matches,
+		size_t first) const
+{
+	if (mCompressed)
+	{
+		// the blocks are visited in order, they stay in the thread cache
+		for (size_t i = first; i < matches.size(); ++i)
+		{
+			matches[i].line = getLineOfOffset(matches[i].offset);
+		}
+		return;
+	}
+
+	buildLineIndex();
+
+	// the matches are nearly sorted, walk the lines forward from the
+	// previous match instead of a binary search each time
+	size_t line = 0;
+	for (size_t i = first; i < matches.size(); ++i)
+	{
+		size_t offset = matches[i].offset;
+		if (line >= mLineStarts.size() || mLineStarts[line] > offset)
+		{
+			line = getLineOfOffset(offset);
+		}
+		while (line + 1 < mLineStarts.size() && mLineStarts[line + 1] <= offset)
+		{
+			++line;
+		}
+		matches[i].line = line;
+	}
+}
+
+size_t TextResource::getLineEnd(size_t line) const
+{
+	size_t end = (line + 1 < mLineStarts.size()) ? mLineStarts[line + 1] : mSize;
+	return trimLineEnd(mText, mLineStarts[line], end);
+}
+
+void TextResource::compress()
+{
+	compress(mText, mSize);
+}
+
+void TextResource::compress(const char * text, size_t textSize)
+{
+	std::vector<Block> blocks;
+	std::string compressedData;
+	std::string compressedBlock;
+	size_t lineCount = 0;
+
+	size_t offset = 0;
+	while (offset < textSize)
+	{
+		// end the block after a line break, lines are never split
+		size_t end = textSize;
+		if (offset + mBlockSize < textSize)
+		{
+			const void * newline = std::memchr(text + offset + mBlockSize - 1,
+					'\n', textSize - (offset + mBlockSize - 1));
+			if (newline)
+			{
+				end = static_cast<const char *>(newline) - text + 1;
+			}
+		}
+
+		Block block;
+		block.offset = offset;
+		block.size = end - offset;
+		block.firstLine = lineCount;
+		block.compressedOffset = compressedData.size();
+
+		lz4Compress(text + offset, block.size, compressedBlock);
+		block.compressedSize = compressedBlock.size();
+		compressedData += compressedBlock;
+		blocks.push_back(block);
+
+		// only the very last line can be without a line break
+		lineCount += countByte(text + offset, block.size, '\n');
+		if (text[end - 1] != '\n')
+		{
+			++lineCount;
+		}
+		offset = end;
+	}
+
+	close();
+	mBlocks.swap(blocks);
+	mCompressedData.swap(compressedData);
+	mSize = textSize;
+	mLineCount = lineCount;
+	mCompressed = true;
+	mContentId = sNextContentId++;
+	setLoaded(true);
+}
+
+void TextResource::decompress()
+{
+	std::string text;
+	copyText(text);
+	takeText(text);
+}
+
+void TextResource::takeText(std::string& text)
+{
+	close();
+	mOwnedText.swap(text);
+	mText = mOwnedText.data();
+	mSize = mOwnedText.size();
+	if (mCompression)
+	{
+		compress();
+	}
+	setLoaded(true);
+}
+
+size_t TextResource::findBlockOfLine(size_t line) const
+{
+	size_t low = 0;
+	size_t high = mBlocks.size();
+	while (high - low > 1)
+	{
+		size_t middle = (low + high) / 2;
+		if (mBlocks[middle].firstLine <= line)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return low;
+}
+
+size_t TextResource::findBlockOfOffset(size_t offset) const
+{
+	size_t low = 0;
+	size_t high = mBlocks.size();
+	while (high - low > 1)
+	{
+		size_t middle = (low + high) / 2;
+		if (mBlocks[middle].offset <= offset)
+		{
+			low = middle;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return low;
+}
+
+const TextResource::CachedBlock& TextResource::getCachedBlock(
+		size_t block) const
+{
+	static thread_local CachedBlock entries[CACHED_BLOCK_COUNT];
+	static thread_local unsigned long clock = 0;
+
+	++clock;
+	CachedBlock * oldest = &entries[0];
+	for (int i = 0; i < CACHED_BLOCK_COUNT; ++i)
+	{
+		if (entries[i].contentId == mContentId && entries[i].block == block)
+		{
+			entries[i].lastUse = clock;
+			return entries[i];
+		}
+		if (entries[i].lastUse < oldest->lastUse)
+		{
+			oldest = &entries[i];
+		}
+	}
+
+	oldest->contentId = mContentId;
+	oldest->block = block;
+	oldest->lastUse = clock;
+	oldest->text.resize(mBlocks[block].size);
+	decompressBlock(block, &oldest->text[0]);
+
+	oldest->lineStarts.clear();
+	oldest->lineStarts.push_back(0);
+	findByte(oldest->text.data(), oldest->text.size(), '\n',
+			oldest->lineStarts, 1);
+	if (oldest->lineStarts.back() == oldest->text.size())
+	{
+		oldest->lineStarts.pop_back();
+	}
+	return *oldest;
+}
+
+bool TextResource::decompressBlock(size_t block, char * out) const
+{
+	const Block& info = mBlocks[block];
+	if (!lz4Decompress(mCompressedData.data() + info.compressedOffset,
+			info.compressedSize, out, info.size))
+	{
+		// checkBlocks() rules it out, never leave garbage anyway
+		std::memset(out, 0, info.size);
+		return false;
+	}
+	return true;
+}
+
+bool TextResource::checkBlocks() const
+{
+	std::string text;
+	size_t offset = 0;
+	size_t lineCount = 0;
+	for (size_t b = 0; b < mBlocks.size(); ++b)
+	{
+		// contiguous, in order and not empty, written without overflow
+		const Block& block = mBlocks[b];
+		if (block.offset != offset || block.size == 0
+				|| block.size > mSize - offset
+				|| block.firstLine != lineCount
+				|| block.compressedOffset > mCompressedData.size()
+				|| block.compressedSize
+						> mCompressedData.size() - block.compressedOffset)
+		{
+			return false;
+		}
+
+		// a LZ4 byte expands to 255 bytes at most, don't allocate more
+		if (block.size / 255 > block.compressedSize)
+		{
+			return false;
+		}
+
+		text.resize(block.size);
+		if (!decompressBlock(b, &text[0]))
+		{
+			return false;
+		}
+
+		// lines aren't split, only the last one can be without a break
+		bool lastBlock = (b + 1 == mBlocks.size());
+		lineCount += countByte(text.data(), text.size(), '\n');
+		if (text[text.size() - 1] != '\n')
+		{
+			if (!lastBlock)
+			{
+				return false;
+			}
+			++lineCount;
+		}
+		offset += block.size;
+	}
+	return offset == mSize && lineCount == mLineCount;
+}
+
 } /* namespace Util */
@@ -0,0 +1,277 @@
+/*
+ * @file	TVector2Array.cpp
+ * @date	2026-10-19
+ * @brief	Vectorized kernels of TVector2Array<float>.
+ */
+
+#include "Util/TVector2Array.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+
+/*
+ * A pack of floats and the operations the kernels need, so each kernel
+ * is written once for AVX and SSE. The loads are unaligned ones, as fast
+ * as the aligned ones on aligned data, and the arrays given to the free
+ * functions don't have to come from a TVector2Array.
+ */
+#if defined(__AVX__)
+typedef __m256 Pack;
+const size_t PACK_SIZE = 8;
+
+inline Pack load(const float * p)
+{
+	return _mm256_loadu_ps(p);
+}
+inline void store(float * p, Pack a)
+{
+	_mm256_storeu_ps(p, a);
+}
+inline Pack set1(float a)
+{
+	return _mm256_set1_ps(a);
+}
+inline Pack add(Pack a, Pack b)
+{
+	return _mm256_add_ps(a, b);
+}
+inline Pack sub(Pack a, Pack b)
+{
+	return _mm256_sub_ps(a, b);
+}
+inline Pack mul(Pack a, Pack b)
+{
+	return _mm256_mul_ps(a, b);
+}
+inline Pack div(Pack a, Pack b)
+{
+	return _mm256_div_ps(a, b);
+}
+inline Pack sqrt(Pack a)
+{
+	return _mm256_sqrt_ps(a);
+}
+
+/**
+ * b where mask is zero, c elsewhere
+ */
+inline Pack selectIfZero(Pack mask, Pack b, Pack c)
+{
+	return _mm256_blendv_ps(c, b,
+			_mm256_cmp_ps(mask, _mm256_setzero_ps(), _CMP_EQ_OQ));
+}
+#elif defined(__SSE__)
+typedef __m128 Pack;
+const size_t PACK_SIZE = 4;
+
+inline Pack load(const float * p)
+{
+	return _mm_loadu_ps(p);
+}
+inline void store(float * p, Pack a)
+{
+	_mm_storeu_ps(p, a);
+}
+inline Pack set1(float a)
+{
+	return _mm_set1_ps(a);
+}
+inline Pack add(Pack a, Pack b)
+{
+	return _mm_add_ps(a, b);
+}
+inline Pack sub(Pack a, Pack b)
+{
+	return _mm_sub_ps(a, b);
+}
+inline Pack mul(Pack a, Pack b)
+{
+	return _mm_mul_ps(a, b);
+}
+inline Pack div(Pack a, Pack b)
+{
+	return _mm_div_ps(a, b);
+}
+inline Pack sqrt(Pack a)
+{
+	return _mm_sqrt_ps(a);
+}
+
+inline Pack selectIfZero(Pack mask, Pack b, Pack c)
+{
+	Pack zero = _mm_cmpeq_ps(mask, _mm_setzero_ps());
+	return _mm_or_ps(_mm_and_ps(zero, b), _mm_andnot_ps(zero, c));
+}
+#else
+const size_t PACK_SIZE = 0;
+#endif
+
+/**
+ * Number of elements done with packs, the rest is left to the scalar
+ * loops of the generic kernels.
+ */
+inline size_t packedCount(size_t count)
+{
+	return PACK_SIZE ? count - count % PACK_SIZE : 0;
+}
+
+}
+
+void Util::addVectors(float * x, float * y, const float * otherX,
+		const float * otherY, size_t count)
+{
+	size_t packed = packedCount(count);
+#if defined(__AVX__) || defined(__SSE__)
+	for (size_t i = 0; i < packed; i += PACK_SIZE)
+	{
+		store(x + i, add(load(x + i), load(otherX + i)));
+		store(y + i, add(load(y + i), load(otherY + i)));
+	}
+#endif
+	addVectors<float>(x + packed, y + packed, otherX + packed, otherY + packed,
+			count - packed);
+}
+
+void Util::translateVectors(float * x, float * y, float dx, float dy,
+		size_t count)
+{
+	size_t packed = packedCount(count);
+#if defined(__AVX__) || defined(__SSE__)
+	Pack packX = set1(dx);
+	Pack packY = set1(dy);
+	for (size_t i = 0; i < packed; i += PACK_SIZE)
+	{
+		store(x + i, add(load(x + i), packX));
+		store(y + i, add(load(y + i), packY));
+	}
+#endif
+	translateVectors<float>(x + packed, y + packed, dx, dy, count - packed);
+}
+
+void Util::scaleVectors(float * x, float * y, float scalar, size_t count)
+{
+	size_t packed = packedCount(count);
+#if defined(__AVX__) || defined(__SSE__)
+	Pack packScalar = set1(scalar);
+	for (size_t i = 0; i < packed; i += PACK_SIZE)
+	{
+		store(x + i, mul(load(x + i), packScalar));
+		store(y + i, mul(load(y + i), packScalar));
+	}
+#endif
+	scaleVectors<float>(x + packed, y + packed, scalar, count - packed);
+}
+
+void Util::dotVectors(const float * x, const float * y, const float * otherX,
+		const float * otherY, float * out, size_t count)
+{
+	size_t packed = packedCount(count);
+#if defined(__AVX__) || defined(__SSE__)
+	for (size_t i = 0; i < packed; i += PACK_SIZE)
+	{
+		store(out + i, add(mul(load(x + i), load(otherX + i)),
+				mul(load(y + i), load(otherY + i))));
+	}
+#endif
+	dotVectors<float>(x + packed, y + packed, otherX + packed, otherY + packed,
+			out + packed, count - packed);
+}
+
+void Util::normalizeVectors(float * x, float * y, size_t count)
+{
+	size_t packed = packedCount(count);
+#if defined(__AVX__) || defined(__SSE__)
+	for (size_t i = 0; i < packed; i += PACK_SIZE)
+	{
+		Pack packX = load(x + i);
+		Pack packY = load(y + i);
+		Pack magnitude = sqrt(add(mul(packX, packX), mul(packY, packY)));
+		// like TVector2::normalize(), a null vector isn't divided
+		store(x + i, selectIfZero(magnitude, packX, div(packX, magnitude)));
+		store(y + i, selectIfZero(magnitude, packY, div(packY, magnitude)));
+	}
+#endif
+	normalizeVectors<float>(x + packed, y + packed, count - packed);
+}
+
+void Util::rotateVectors(float * x, float * y, float cosAngle,
+		float sinAngle, size_t count)
+{
+	size_t packed = packedCount(count);
+#if defined(__AVX__) || defined(__SSE__)
+	Pack packCos = set1(cosAngle);
+	Pack packSin = set1(sinAngle);
+	for (size_t i = 0; i < packed; i += PACK_SIZE)
+	{
+		Pack packX = load(x + i);
+		Pack packY = load(y + i);
+		store(x + i, sub(mul(packX, packCos), mul(packY, packSin)));
+		store(y + i, add(mul(packY, packCos), mul(packX, packSin)));
+	}
+#endif
+	rotateVectors<float>(x + packed, y + packed, cosAngle, sinAngle,
+			count - packed);
+}
+
+void Util::distanceVectors(const float * x, const float * y,
+		const float * otherX, const float * otherY, float * out, size_t count)
+{
+	size_t packed = packedCount(count);
+#if defined(__AVX__) || defined(__SSE__)
+	for (size_t i = 0; i < packed; i += PACK_SIZE)
+	{
+		Pack dx = sub(load(otherX + i), load(x + i));
+		Pack dy = sub(load(otherY + i), load(y + i));
+		store(out + i, sqrt(add(mul(dx, dx), mul(dy, dy))));
+	}
+#endif
+	distanceVectors<float>(x + packed, y + packed, otherX + packed,
+			otherY + packed, out + packed, count - packed);
+}
+
+// splitVectors() and joinVectors() read and write the vectors as floats
+static_assert(sizeof(Util::TVector2<float>) == 2 * sizeof(float),
+		"a TVector2<float> must be its x and y only");
+
+void Util::splitVectors(const TVector2<float> * vectors, float * x,
+		float * y, size_t count)
+{
+	size_t i = 0;
+#if defined(__SSE__)
+	// a TVector2<float> is its x and y, nothing else
+	const float * xy = reinterpret_cast<const float *>(vectors);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 first = _mm_loadu_ps(xy + i * 2);
+		__m128 second = _mm_loadu_ps(xy + i * 2 + 4);
+		_mm_storeu_ps(x + i, _mm_shuffle_ps(first, second,
+				_MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(y + i, _mm_shuffle_ps(first, second,
+				_MM_SHUFFLE(3, 1, 3, 1)));
+	}
+#endif
+	splitVectors<float>(vectors + i, x + i, y + i, count - i);
+}
+
+void Util::joinVectors(const float * x, const float * y,
+		TVector2<float> * vectors, size_t count)
+{
+	size_t i = 0;
+#if defined(__SSE__)
+	float * xy = reinterpret_cast<float *>(vectors);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 packX = _mm_loadu_ps(x + i);
+		__m128 packY = _mm_loadu_ps(y + i);
+		_mm_storeu_ps(xy + i * 2, _mm_unpacklo_ps(packX, packY));
+		_mm_storeu_ps(xy + i * 2 + 4, _mm_unpackhi_ps(packX, packY));
+	}
+#endif
+	joinVectors<float>(x + i, y + i, vectors + i, count - i);
+}
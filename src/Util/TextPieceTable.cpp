@@ -0,0 +1,609 @@
+/*
+ * @file	TextPieceTable.cpp
+ * @date	2026-10-19
+ * @brief	Editable text made of pieces of unchanged buffers.
+ */
+
+#include "Util/TextPieceTable.h"
+#include "Util/TextScan.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Util
+{
+
+const size_t TextPieceTable::MAX_PIECE_SIZE;
+
+namespace
+{
+
+/**
+ * Capacity of each buffer of inserted characters
+ */
+const size_t ADD_BUFFER_SIZE = 64 * 1024;
+
+}
+
+TextPieceTable::Snapshot::Snapshot()
+{
+}
+
+size_t TextPieceTable::Snapshot::getSize() const
+{
+	return mRoot ? mRoot->size : 0;
+}
+
+TextPieceTable::TextPieceTable() :
+				mSeed(2463534242u)
+{
+}
+
+TextPieceTable::TextPieceTable(TextView original) :
+				mSeed(2463534242u)
+{
+	reset(original);
+}
+
+void TextPieceTable::reset(TextView original)
+{
+	mRoot.reset();
+	clearHistory();
+	mAddBuffers.clear();
+
+	std::vector<TextView> pieces;
+	for (size_t offset = 0; offset < original.size(); offset += MAX_PIECE_SIZE)
+	{
+		pieces.push_back(original.substr(offset, MAX_PIECE_SIZE));
+	}
+	mRoot = build(pieces, 0, pieces.size());
+}
+
+size_t TextPieceTable::getSize() const
+{
+	return mRoot ? mRoot->size : 0;
+}
+
+bool TextPieceTable::empty() const
+{
+	return getSize() == 0;
+}
+
+size_t TextPieceTable::getPieceCount() const
+{
+	return mRoot ? mRoot->pieces : 0;
+}
+
+void TextPieceTable::insert(size_t offset, TextView text)
+{
+	if (text.empty())
+	{
+		return;
+	}
+	pushHistory();
+	mRoot = insertInto(mRoot, offset, text);
+}
+
+void TextPieceTable::erase(size_t offset, size_t length)
+{
+	if (offset >= getSize() || length == 0)
+	{
+		return;
+	}
+	pushHistory();
+	mRoot = eraseFrom(mRoot, offset, length);
+}
+
+void TextPieceTable::replace(size_t offset, size_t length, TextView text)
+{
+	pushHistory();
+	NodePtr root = eraseFrom(mRoot, offset, length);
+	mRoot = insertInto(root, offset, text);
+}
+
+char TextPieceTable::at(size_t offset) const
+{
+	const Node * node = mRoot.get();
+	while (node != NULL)
+	{
+		size_t leftSize = node->left ? node->left->size : 0;
+		if (offset < leftSize)
+		{
+			node = node->left.get();
+		}
+		else if (offset - leftSize < node->piece.size())
+		{
+			return node->piece[offset - leftSize];
+		}
+		else
+		{
+			offset -= leftSize + node->piece.size();
+			node = node->right.get();
+		}
+	}
+	return '\0';
+}
+
+void TextPieceTable::copyText(size_t offset, size_t length,
+		std::string& outText) const
+{
+	outText.clear();
+	forEachPiece(offset, length, [&outText](TextView piece)
+	{
+		outText.append(piece.data(), piece.size());
+	});
+}
+
+void TextPieceTable::copyText(std::string& outText) const
+{
+	outText.reserve(getSize());
+	copyText(0, getSize(), outText);
+}
+
+size_t TextPieceTable::getLineCount() const
+{
+	size_t size = getSize();
+	if (size == 0)
+	{
+		return 0;
+	}
+
+	// only the very last line can be without a line break
+	size_t breaks = mRoot->breaks;
+	return (at(size - 1) == '\n') ? breaks : breaks + 1;
+}
+
+size_t TextPieceTable::getLineOffset(size_t line) const
+{
+	if (line >= getLineCount())
+	{
+		return getSize();
+	}
+	return (line == 0) ? 0 : findBreak(line - 1) + 1;
+}
+
+size_t TextPieceTable::getLineOfOffset(size_t offset) const
+{
+	// count the line breaks before offset
+	size_t line = 0;
+	const Node * node = mRoot.get();
+	while (node != NULL)
+	{
+		size_t leftSize = node->left ? node->left->size : 0;
+		size_t leftBreaks = node->left ? node->left->breaks : 0;
+		if (offset < leftSize)
+		{
+			node = node->left.get();
+		}
+		else if (offset - leftSize < node->piece.size())
+		{
+			line += leftBreaks
+					+ countByte(node->piece.data(), offset - leftSize, '\n');
+			break;
+		}
+		else
+		{
+			line += leftBreaks + node->pieceBreaks;
+			offset -= leftSize + node->piece.size();
+			node = node->right.get();
+		}
+	}
+
+	size_t lineCount = getLineCount();
+	return (line < lineCount || lineCount == 0) ? line : lineCount - 1;
+}
+
+void TextPieceTable::copyLine(size_t line, std::string& outLine) const
+{
+	size_t lineCount = getLineCount();
+	if (line >= lineCount)
+	{
+		outLine.clear();
+		return;
+	}
+
+	size_t begin = getLineOffset(line);
+	size_t end = (line + 1 < lineCount) ? getLineOffset(line + 1) : getSize();
+	copyText(begin, end - begin, outLine);
+
+	if (!outLine.empty() && outLine[outLine.size() - 1] == '\n')
+	{
+		outLine.erase(outLine.size() - 1);
+	}
+	if (!outLine.empty() && outLine[outLine.size() - 1] == '\r')
+	{
+		outLine.erase(outLine.size() - 1);
+	}
+}
+
+TextPieceTable::Snapshot TextPieceTable::getSnapshot() const
+{
+	Snapshot snapshot;
+	snapshot.mRoot = mRoot;
+	return snapshot;
+}
+
+void TextPieceTable::restore(const Snapshot& snapshot)
+{
+	pushHistory();
+	mRoot = snapshot.mRoot;
+}
+
+bool TextPieceTable::canUndo() const
+{
+	return !mUndo.empty();
+}
+
+bool TextPieceTable::canRedo() const
+{
+	return !mRedo.empty();
+}
+
+bool TextPieceTable::undo()
+{
+	if (mUndo.empty())
+	{
+		return false;
+	}
+	mRedo.push_back(mRoot);
+	mRoot = mUndo.back();
+	mUndo.pop_back();
+	return true;
+}
+
+bool TextPieceTable::redo()
+{
+	if (mRedo.empty())
+	{
+		return false;
+	}
+	mUndo.push_back(mRoot);
+	mRoot = mRedo.back();
+	mRedo.pop_back();
+	return true;
+}
+
+void TextPieceTable::clearHistory()
+{
+	mUndo.clear();
+	mRedo.clear();
+}
+
+TextPieceTable::NodePtr TextPieceTable::makeNode(TextView piece,
+		size_t pieceBreaks, unsigned int priority, const NodePtr& left,
+		const NodePtr& right)
+{
+	std::shared_ptr<Node> node = std::make_shared<Node>();
+	node->piece = piece;
+	node->pieceBreaks = pieceBreaks;
+	node->priority = priority;
+	node->left = left;
+	node->right = right;
+	node->size = piece.size();
+	node->breaks = pieceBreaks;
+	node->pieces = 1;
+	if (left)
+	{
+		node->size += left->size;
+		node->breaks += left->breaks;
+		node->pieces += left->pieces;
+	}
+	if (right)
+	{
+		node->size += right->size;
+		node->breaks += right->breaks;
+		node->pieces += right->pieces;
+	}
+	return node;
+}
+
+TextPieceTable::NodePtr TextPieceTable::build(
+		const std::vector<TextView>& pieces, size_t begin, size_t end)
+{
+	if (begin == end)
+	{
+		return NodePtr();
+	}
+
+	// the middle piece at the root, with a priority above its children
+	size_t middle = begin + (end - begin) / 2;
+	NodePtr left = build(pieces, begin, middle);
+	NodePtr right = build(pieces, middle + 1, end);
+
+	unsigned int priority = nextPriority();
+	if (left)
+	{
+		priority = std::max(priority, left->priority);
+	}
+	if (right)
+	{
+		priority = std::max(priority, right->priority);
+	}
+
+	const TextView& piece = pieces[middle];
+	return makeNode(piece, countByte(piece.data(), piece.size(), '\n'),
+			priority, left, right);
+}
+
+TextPieceTable::NodePtr TextPieceTable::merge(const NodePtr& left,
+		const NodePtr& right)
+{
+	if (!left)
+	{
+		return right;
+	}
+	if (!right)
+	{
+		return left;
+	}
+
+	if (left->priority > right->priority)
+	{
+		return makeNode(left->piece, left->pieceBreaks, left->priority,
+				left->left, merge(left->right, right));
+	}
+	return makeNode(right->piece, right->pieceBreaks, right->priority,
+			merge(left, right->left), right->right);
+}
+
+void TextPieceTable::split(const NodePtr& node, size_t offset,
+		NodePtr& outLeft, NodePtr& outRight)
+{
+	// nothing to copy when the cut is at an end
+	if (!node || offset == 0)
+	{
+		outLeft.reset();
+		outRight = node;
+		return;
+	}
+	if (offset >= node->size)
+	{
+		outLeft = node;
+		outRight.reset();
+		return;
+	}
+
+	size_t leftSize = node->left ? node->left->size : 0;
+	size_t pieceSize = node->piece.size();
+	NodePtr left;
+	NodePtr right;
+	if (offset <= leftSize)
+	{
+		split(node->left, offset, left, right);
+		outRight = makeNode(node->piece, node->pieceBreaks, node->priority,
+				right, node->right);
+		outLeft = left;
+	}
+	else if (offset >= leftSize + pieceSize)
+	{
+		split(node->right, offset - leftSize - pieceSize, left, right);
+		outLeft = makeNode(node->piece, node->pieceBreaks, node->priority,
+				node->left, left);
+		outRight = right;
+	}
+	else
+	{
+		// count the line breaks on the shorter part
+		size_t cut = offset - leftSize;
+		TextView head = node->piece.substr(0, cut);
+		TextView tail = node->piece.substr(cut);
+		size_t headBreaks = (cut <= pieceSize / 2) ?
+				countByte(head.data(), head.size(), '\n') :
+				node->pieceBreaks - countByte(tail.data(), tail.size(), '\n');
+
+		// both halves keep the priority, they stay above their children
+		outLeft = makeNode(head, headBreaks, node->priority, node->left,
+				NodePtr());
+		outRight = makeNode(tail, node->pieceBreaks - headBreaks,
+				node->priority, NodePtr(), node->right);
+	}
+}
+
+TextPieceTable::NodePtr TextPieceTable::insertNode(const NodePtr& node,
+		size_t offset, const NodePtr& inserted)
+{
+	if (!node)
+	{
+		return inserted;
+	}
+
+	// the new node goes above every node with a lower priority
+	size_t leftSize = node->left ? node->left->size : 0;
+	size_t pieceSize = node->piece.size();
+	if (inserted->priority > node->priority
+			|| (offset > leftSize && offset < leftSize + pieceSize))
+	{
+		NodePtr left;
+		NodePtr right;
+		split(node, offset, left, right);
+		if (inserted->priority > std::max(left ? left->priority : 0,
+				right ? right->priority : 0))
+		{
+			return makeNode(inserted->piece, inserted->pieceBreaks,
+					inserted->priority, left, right);
+		}
+		return merge(merge(left, inserted), right);
+	}
+
+	if (offset <= leftSize)
+	{
+		return makeNode(node->piece, node->pieceBreaks, node->priority,
+				insertNode(node->left, offset, inserted), node->right);
+	}
+	return makeNode(node->piece, node->pieceBreaks, node->priority,
+			node->left,
+			insertNode(node->right, offset - leftSize - pieceSize, inserted));
+}
+
+TextPieceTable::NodePtr TextPieceTable::extendPiece(const NodePtr& node,
+		size_t offset, TextView added)
+{
+	if (!node)
+	{
+		return NodePtr();
+	}
+
+	size_t leftSize = node->left ? node->left->size : 0;
+	size_t pieceSize = node->piece.size();
+	if (offset < leftSize)
+	{
+		NodePtr left = extendPiece(node->left, offset, added);
+		return left ?
+				makeNode(node->piece, node->pieceBreaks, node->priority, left,
+						node->right) :
+				NodePtr();
+	}
+	if (offset >= leftSize + pieceSize)
+	{
+		NodePtr right = extendPiece(node->right,
+				offset - leftSize - pieceSize, added);
+		return right ?
+				makeNode(node->piece, node->pieceBreaks, node->priority,
+						node->left, right) :
+				NodePtr();
+	}
+
+	if (offset + 1 != leftSize + pieceSize
+			|| node->piece.end() != added.data()
+			|| pieceSize + added.size() > MAX_PIECE_SIZE)
+	{
+		return NodePtr();
+	}
+	TextView piece(node->piece.data(), pieceSize + added.size());
+	return makeNode(piece,
+			node->pieceBreaks + countByte(added.data(), added.size(), '\n'),
+			node->priority, node->left, node->right);
+}
+
+size_t TextPieceTable::findBreak(size_t index) const
+{
+	size_t offset = 0;
+	const Node * node = mRoot.get();
+	while (node != NULL)
+	{
+		size_t leftBreaks = node->left ? node->left->breaks : 0;
+		size_t leftSize = node->left ? node->left->size : 0;
+		if (index < leftBreaks)
+		{
+			node = node->left.get();
+			continue;
+		}
+
+		index -= leftBreaks;
+		if (index < node->pieceBreaks)
+		{
+			const char * data = node->piece.data();
+			const char * end = node->piece.end();
+			const char * found = data;
+			for (;;)
+			{
+				found = static_cast<const char *>(std::memchr(found, '\n',
+						end - found));
+				if (index == 0)
+				{
+					return offset + leftSize + (found - data);
+				}
+				--index;
+				++found;
+			}
+		}
+
+		index -= node->pieceBreaks;
+		offset += leftSize + node->piece.size();
+		node = node->right.get();
+	}
+	return getSize();
+}
+
+TextView TextPieceTable::append(TextView text)
+{
+	if (mAddBuffers.empty()
+			|| mAddBuffers.back().capacity() - mAddBuffers.back().size()
+					< text.size())
+	{
+		mAddBuffers.push_back(std::string());
+		mAddBuffers.back().reserve(std::max(ADD_BUFFER_SIZE, text.size()));
+	}
+
+	// within the capacity, the characters already there don't move
+	std::string& buffer = mAddBuffers.back();
+	size_t offset = buffer.size();
+	buffer.append(text.data(), text.size());
+	return TextView(buffer.data() + offset, text.size());
+}
+
+TextPieceTable::NodePtr TextPieceTable::makePieces(TextView text)
+{
+	std::vector<TextView> pieces;
+	for (size_t offset = 0; offset < text.size(); offset += MAX_PIECE_SIZE)
+	{
+		pieces.push_back(text.substr(offset, MAX_PIECE_SIZE));
+	}
+	return build(pieces, 0, pieces.size());
+}
+
+TextPieceTable::NodePtr TextPieceTable::insertInto(const NodePtr& root,
+		size_t offset, TextView text)
+{
+	if (text.empty())
+	{
+		return root;
+	}
+	size_t size = root ? root->size : 0;
+	offset = std::min(offset, size);
+
+	// typing at the same place appends right after the previous insert,
+	// the piece before grows instead of adding one more
+	TextView added = append(text);
+	if (offset > 0 && added.data() != mAddBuffers.back().data())
+	{
+		NodePtr extended = extendPiece(root, offset - 1, added);
+		if (extended)
+		{
+			return extended;
+		}
+	}
+
+	if (added.size() <= MAX_PIECE_SIZE)
+	{
+		NodePtr inserted = makeNode(added,
+				countByte(added.data(), added.size(), '\n'), nextPriority(),
+				NodePtr(), NodePtr());
+		return insertNode(root, offset, inserted);
+	}
+
+	NodePtr left;
+	NodePtr right;
+	split(root, offset, left, right);
+	return merge(merge(left, makePieces(added)), right);
+}
+
+TextPieceTable::NodePtr TextPieceTable::eraseFrom(const NodePtr& root,
+		size_t offset, size_t length)
+{
+	NodePtr left;
+	NodePtr rest;
+	split(root, offset, left, rest);
+
+	NodePtr erased;
+	NodePtr right;
+	split(rest, length, erased, right);
+	return merge(left, right);
+}
+
+void TextPieceTable::pushHistory()
+{
+	mUndo.push_back(mRoot);
+	mRedo.clear();
+}
+
+unsigned int TextPieceTable::nextPriority()
+{
+	// xorshift, the tree only needs the priorities spread out
+	mSeed ^= mSeed << 13;
+	mSeed ^= mSeed >> 17;
+	mSeed ^= mSeed << 5;
+	return mSeed;
+}
+
+}
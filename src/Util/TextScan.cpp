@@ -0,0 +1,101 @@
+/*
+ * @file	TextScan.cpp
+ * @date	2026-10-19
+ * @brief	Vectorized byte scanning over large buffers.
+ */
+
+#include "Util/TextScan.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+#if defined(__AVX2__)
+const size_t BLOCK_SIZE = 32;
+
+/**
+ * One bit per byte of the block equal to c
+ */
+inline unsigned int matchMask(const char * block, __m256i pattern)
+{
+	__m256i bytes = _mm256_loadu_si256(
+			reinterpret_cast<const __m256i *>(block));
+	return static_cast<unsigned int>(_mm256_movemask_epi8(
+			_mm256_cmpeq_epi8(bytes, pattern)));
+}
+#elif defined(__SSE2__)
+const size_t BLOCK_SIZE = 16;
+
+inline unsigned int matchMask(const char * block, __m128i pattern)
+{
+	__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+	return static_cast<unsigned int>(_mm_movemask_epi8(
+			_mm_cmpeq_epi8(bytes, pattern)));
+}
+#endif
+
+}
+
+size_t Util::countByte(const char * data, size_t size, char c)
+{
+	size_t count = 0;
+	size_t i = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#if defined(__AVX2__)
+	__m256i pattern = _mm256_set1_epi8(c);
+#else
+	__m128i pattern = _mm_set1_epi8(c);
+#endif
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE)
+	{
+		count += __builtin_popcount(matchMask(data + i, pattern));
+	}
+#endif
+
+	// what's left, or everything without SIMD
+	for (; i < size; ++i)
+	{
+		if (data[i] == c)
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+void Util::findByte(const char * data, size_t size, char c,
+		std::vector<size_t>& outPositions, size_t baseOffset)
+{
+	size_t i = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#if defined(__AVX2__)
+	__m256i pattern = _mm256_set1_epi8(c);
+#else
+	__m128i pattern = _mm_set1_epi8(c);
+#endif
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE)
+	{
+		unsigned int mask = matchMask(data + i, pattern);
+		while (mask != 0)
+		{
+			outPositions.push_back(baseOffset + i + __builtin_ctz(mask));
+			mask &= mask - 1; // clear the lowest bit
+		}
+	}
+#endif
+
+	for (; i < size; ++i)
+	{
+		if (data[i] == c)
+		{
+			outPositions.push_back(baseOffset + i);
+		}
+	}
+}
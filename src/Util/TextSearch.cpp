@@ -0,0 +1,285 @@
+/*
+ * @file	TextSearch.cpp
+ * @date	2026-10-19
+ * @brief	Substring and multi-pattern search over large texts.
+ */
+
+#include "Util/TextSearch.h"
+
+#include <cstring>
+#include <deque>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+/**
+ * Call found(offset) for each occurrence from the offset from, until it
+ * returns false. See "SIMD-friendly algorithms for substring searching"
+ * by Wojciech Mula, the generic SIMD variant.
+ */
+template<typename Found>
+void searchPattern(const char * text, size_t size, const char * pattern,
+		size_t length, size_t from, Found found)
+{
+	if (length == 0 || length > size)
+	{
+		return;
+	}
+
+	size_t i = from;
+	size_t lastStart = size - length; // last possible offset of a match
+
+#if defined(__AVX2__) || defined(__SSE2__)
+	if (length > 1)
+	{
+#if defined(__AVX2__)
+		const size_t blockSize = 32;
+		__m256i first = _mm256_set1_epi8(pattern[0]);
+		__m256i last = _mm256_set1_epi8(pattern[length - 1]);
+#else
+		const size_t blockSize = 16;
+		__m128i first = _mm_set1_epi8(pattern[0]);
+		__m128i last = _mm_set1_epi8(pattern[length - 1]);
+#endif
+		for (; i + blockSize <= lastStart + 1; i += blockSize)
+		{
+#if defined(__AVX2__)
+			__m256i blockFirst = _mm256_loadu_si256(
+					reinterpret_cast<const __m256i *>(text + i));
+			__m256i blockLast = _mm256_loadu_si256(
+					reinterpret_cast<const __m256i *>(text + i + length - 1));
+			unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(
+					_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first),
+							_mm256_cmpeq_epi8(blockLast, last))));
+#else
+			__m128i blockFirst = _mm_loadu_si128(
+					reinterpret_cast<const __m128i *>(text + i));
+			__m128i blockLast = _mm_loadu_si128(
+					reinterpret_cast<const __m128i *>(text + i + length - 1));
+			unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(
+					_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+							_mm_cmpeq_epi8(blockLast, last))));
+#endif
+			while (mask != 0)
+			{
+				size_t candidate = i + __builtin_ctz(mask);
+				if (std::memcmp(text + candidate + 1, pattern + 1, length - 2)
+						== 0)
+				{
+					if (!found(candidate))
+					{
+						return;
+					}
+				}
+				mask &= mask - 1;
+			}
+		}
+	}
+#endif
+
+	// what's left, or everything without SIMD
+	for (; i <= lastStart; ++i)
+	{
+		if (text[i] == pattern[0]
+				&& std::memcmp(text + i, pattern, length) == 0)
+		{
+			if (!found(i))
+			{
+				return;
+			}
+		}
+	}
+}
+
+}
+
+namespace Util
+{
+
+size_t findFirst(TextView text, TextView pattern, size_t from)
+{
+	size_t result = std::string::npos;
+	searchPattern(text.data(), text.size(), pattern.data(), pattern.size(),
+			from, [&result](size_t offset) {
+				result = offset;
+				return false;
+			});
+	return result;
+}
+
+void findAll(TextView text, TextView pattern, std::vector<size_t>& outOffsets)
+{
+	searchPattern(text.data(), text.size(), pattern.data(), pattern.size(), 0,
+			[&outOffsets](size_t offset) {
+				outOffsets.push_back(offset);
+				return true;
+			});
+}
+
+TextPatternSet::TextPatternSet() :
+				mClassCount(1),
+				mBuilt(false)
+{
+	std::memset(mByteClass, 0, sizeof(mByteClass));
+}
+
+size_t TextPatternSet::addPattern(TextView pattern)
+{
+	mPatterns.push_back(pattern.str());
+	mBuilt = false;
+	return mPatterns.size() - 1;
+}
+
+size_t TextPatternSet::getPatternCount() const
+{
+	return mPatterns.size();
+}
+
+TextView TextPatternSet::getPattern(size_t index) const
+{
+	return TextView(mPatterns[index]);
+}
+
+void TextPatternSet::build()
+{
+	// class 0 is every byte that isn't in a pattern
+	std::memset(mByteClass, 0, sizeof(mByteClass));
+	mClassCount = 1;
+	for (size_t p = 0; p < mPatterns.size(); ++p)
+	{
+		for (size_t i = 0; i < mPatterns[p].size(); ++i)
+		{
+			unsigned char c = static_cast<unsigned char>(mPatterns[p][i]);
+			if (mByteClass[c] == 0)
+			{
+				mByteClass[c] = static_cast<unsigned short>(mClassCount++);
+			}
+		}
+	}
+
+	// trie, 0 is "no transition" except for the root
+	mTransitions.assign(mClassCount, 0);
+	std::vector<std::vector<unsigned int> > outputs(1);
+	for (size_t p = 0; p < mPatterns.size(); ++p)
+	{
+		if (mPatterns[p].empty())
+		{
+			continue;
+		}
+		unsigned int state = 0;
+		for (size_t i = 0; i < mPatterns[p].size(); ++i)
+		{
+			unsigned int column = mByteClass[static_cast<unsigned char>(
+					mPatterns[p][i])];
+			unsigned int next = mTransitions[state * mClassCount + column];
+			if (next == 0)
+			{
+				next = static_cast<unsigned int>(outputs.size());
+				outputs.push_back(std::vector<unsigned int>());
+				mTransitions.resize(mTransitions.size() + mClassCount, 0);
+				mTransitions[state * mClassCount + column] = next;
+			}
+			state = next;
+		}
+		outputs[state].push_back(static_cast<unsigned int>(p));
+	}
+
+	// breadth first, turn the trie into a complete automaton
+	size_t stateCount = outputs.size();
+	std::vector<unsigned int> failure(stateCount, 0);
+	std::deque<unsigned int> queue;
+	for (unsigned int column = 0; column < mClassCount; ++column)
+	{
+		unsigned int next = mTransitions[column];
+		if (next != 0)
+		{
+			queue.push_back(next);
+		}
+	}
+	while (!queue.empty())
+	{
+		unsigned int state = queue.front();
+		queue.pop_front();
+
+		// a state also matches what its failure state matches
+		const std::vector<unsigned int>& inherited = outputs[failure[state]];
+		outputs[state].insert(outputs[state].end(), inherited.begin(),
+				inherited.end());
+
+		for (unsigned int column = 0; column < mClassCount; ++column)
+		{
+			unsigned int& next = mTransitions[state * mClassCount + column];
+			unsigned int fallback =
+					mTransitions[failure[state] * mClassCount + column];
+			if (next != 0)
+			{
+				failure[next] = fallback;
+				queue.push_back(next);
+			}
+			else
+			{
+				next = fallback;
+			}
+		}
+	}
+
+	// flatten the outputs
+	mOutputStart.assign(stateCount + 1, 0);
+	mOutputs.clear();
+	for (size_t state = 0; state < stateCount; ++state)
+	{
+		mOutputStart[state] = static_cast<unsigned int>(mOutputs.size());
+		mOutputs.insert(mOutputs.end(), outputs[state].begin(),
+				outputs[state].end());
+	}
+	mOutputStart[stateCount] = static_cast<unsigned int>(mOutputs.size());
+	mBuilt = true;
+}
+
+bool TextPatternSet::isBuilt() const
+{
+	return mBuilt;
+}
+
+void TextPatternSet::findAll(TextView text,
+		std::vector<TextMatch>& outMatches) const
+{
+	scan(text, 0, 0, outMatches);
+}
+
+unsigned int TextPatternSet::scan(TextView part, size_t baseOffset,
+		unsigned int state, std::vector<TextMatch>& outMatches) const
+{
+	if (!mBuilt)
+	{
+		return state;
+	}
+
+	const unsigned char * text =
+			reinterpret_cast<const unsigned char *>(part.data());
+	const unsigned int * transitions = &mTransitions[0];
+	for (size_t i = 0; i < part.size(); ++i)
+	{
+		state = transitions[state * mClassCount + mByteClass[text[i]]];
+
+		unsigned int end = mOutputStart[state + 1];
+		for (unsigned int o = mOutputStart[state]; o < end; ++o)
+		{
+			TextMatch match;
+			match.pattern = mOutputs[o];
+			match.length = mPatterns[match.pattern].size();
+			match.offset = baseOffset + i + 1 - match.length;
+			match.line = 0;
+			outMatches.push_back(match);
+		}
+	}
+	return state;
+}
+
+}
@@ -0,0 +1,118 @@
+/**
+ * @file	ThreadPool.cpp
+ * @date	2026-10-19
+ * @brief	Fixed set of worker threads to split work across cores.
+ */
+
+#include "Util/ThreadPool.h"
+
+namespace Util
+{
+
+ThreadPool::ThreadPool(unsigned int threadCount) :
+				mTask(NULL),
+				mCount(0),
+				mNext(0),
+				mBatch(0),
+				mBusyWorkers(0),
+				mStop(false)
+{
+	if (threadCount == 0)
+	{
+		// hardware_concurrency may return 0 when unknown
+		unsigned int cores = std::thread::hardware_concurrency();
+		threadCount = (cores > 1) ? cores - 1 : 1;
+	}
+
+	for (unsigned int i = 0; i < threadCount; ++i)
+	{
+		mWorkers.push_back(std::thread(&ThreadPool::workerLoop, this));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWorkReady.notify_all();
+
+	for (size_t i = 0; i < mWorkers.size(); ++i)
+	{
+		mWorkers[i].join();
+	}
+}
+
+void ThreadPool::parallelFor(size_t count,
+		const std::function<void(size_t)>& task)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTask = &task;
+		mCount = count;
+		mNext = 0;
+		mBusyWorkers = static_cast<unsigned int>(mWorkers.size());
+		++mBatch;
+	}
+	mWorkReady.notify_all();
+
+	// the caller works too instead of just waiting
+	runTasks();
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (mBusyWorkers > 0)
+	{
+		mWorkDone.wait(lock);
+	}
+	mTask = NULL;
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+	return static_cast<unsigned int>(mWorkers.size());
+}
+
+void ThreadPool::workerLoop()
+{
+	unsigned int lastBatch = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			while (!mStop && mBatch == lastBatch)
+			{
+				mWorkReady.wait(lock);
+			}
+			if (mStop)
+			{
+				return;
+			}
+			lastBatch = mBatch;
+		}
+
+		runTasks();
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			--mBusyWorkers;
+		}
+		mWorkDone.notify_one();
+	}
+}
+
+void ThreadPool::runTasks()
+{
+	size_t index;
+	while ((index = mNext.fetch_add(1)) < mCount)
+	{
+		(*mTask)(index);
+	}
+}
+
+} /* namespace Util */
@@ -0,0 +1,355 @@
+/*
+ * @file	CompressionTest.cpp
+ * @date	2026-10-19
+ * @brief	Round trips of the LZ4 codec, and the TextResource blocks
+ * 			rebuilt from cache entries, corrupted or not.
+ */
+
+#include "Test.h"
+#include "Util/Compression.h"
+#include "Util/Resource/TextResource.h"
+#include "Util/Resource/ResourceCache.h"
+#include "Util/FileHelper.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace
+{
+
+/**
+ * Compress and decompress, the result must be the input
+ */
+bool roundTrip(const std::string& data)
+{
+	std::string compressed;
+	Util::lz4Compress(data.data(), data.size(), compressed);
+
+	// one more byte so an overrun would be seen
+	std::string out(data.size() + 1, '\x5A');
+	if (!Util::lz4Decompress(compressed.data(), compressed.size(), &out[0],
+			data.size()))
+	{
+		return false;
+	}
+	return out.compare(0, data.size(), data) == 0
+			&& out[data.size()] == '\x5A';
+}
+
+std::string randomBytes(size_t size, unsigned int seed)
+{
+	Test::Random random(seed);
+	std::string data(size, '\0');
+	for (size_t i = 0; i < size; ++i)
+	{
+		data[i] = static_cast<char>(random.next(256));
+	}
+	return data;
+}
+
+/**
+ * Lines of random words from a small vocabulary, compresses well
+ */
+std::string randomText(size_t size, unsigned int seed)
+{
+	static const char * const WORDS[] = { "resource", "manager", "lua", "text",
+			"block", "the", "a", "line", "cache", "vector" };
+	Test::Random random(seed);
+	std::string text;
+	while (text.size() < size)
+	{
+		text += WORDS[random.next(10)];
+		text += (random.next(8) == 0) ? '\n' : ' ';
+	}
+	text.resize(size);
+	return text;
+}
+
+void testRoundTrips()
+{
+	CHECK(roundTrip(""));
+	CHECK(roundTrip("a"));
+
+	// around the sizes where the match finder starts
+	for (size_t size = 1; size <= 32; ++size)
+	{
+		CHECK(roundTrip(std::string(size, 'x')));
+		CHECK(roundTrip(randomBytes(size, static_cast<unsigned int>(size))));
+	}
+
+	// incompressible, the output is a bit bigger than the input
+	std::string random = randomBytes(100000, 1);
+	CHECK(roundTrip(random));
+	std::string compressed;
+	Util::lz4Compress(random.data(), random.size(), compressed);
+	CHECK(compressed.size() <= random.size() + random.size() / 255 + 16);
+
+	// long runs, matches of offset 1 that overlap what they write
+	CHECK(roundTrip(std::string(1000000, 'a')));
+	CHECK(roundTrip(std::string(300, 'a') + "b" + std::string(300, 'a')));
+
+	// overlapping matches of short periods
+	for (size_t period = 2; period <= 7; ++period)
+	{
+		std::string pattern = randomBytes(period, 100 + period);
+		std::string data;
+		while (data.size() < 5000)
+		{
+			data += pattern;
+		}
+		CHECK(roundTrip(data));
+	}
+
+	// the 15 and 255 steps of the literal and match lengths
+	const size_t lengths[] = { 14, 15, 16, 18, 19, 20, 269, 270, 271, 525 };
+	for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i)
+	{
+		std::string literals = randomBytes(lengths[i], 200 + i);
+		CHECK(roundTrip(literals + literals + randomBytes(20, 300 + i)));
+		CHECK(roundTrip(randomBytes(8, 400 + i) + std::string(lengths[i], 'm')
+				+ randomBytes(8, 500 + i)));
+	}
+
+	// repeats further than the 65535 bytes an offset can reach
+	std::string far = randomBytes(70000, 2);
+	CHECK(roundTrip(far + far));
+	CHECK(roundTrip(randomText(200000, 3)));
+}
+
+void testCorruptBlocks()
+{
+	std::string data = randomText(4000, 4) + std::string(500, 'z');
+	std::string compressed;
+	Util::lz4Compress(data.data(), data.size(), compressed);
+	std::string out(data.size(), '\0');
+	CHECK(Util::lz4Decompress(compressed.data(), compressed.size(), &out[0],
+			out.size()));
+
+	// every truncation, the output can't be filled
+	for (size_t size = 0; size < compressed.size(); ++size)
+	{
+		CHECK(!Util::lz4Decompress(compressed.data(), size, &out[0],
+				out.size()));
+	}
+
+	// the size must be exact
+	CHECK(!Util::lz4Decompress(compressed.data(), compressed.size(), &out[0],
+			out.size() - 1));
+	std::string bigger(data.size() + 1, '\0');
+	CHECK(!Util::lz4Decompress(compressed.data(), compressed.size(),
+			&bigger[0], bigger.size()));
+
+	// a match before the start of the output, then an offset of 0
+	const char farMatch[] = { '\x10', 'a', '\x05', '\x00', '\x00' };
+	CHECK(!Util::lz4Decompress(farMatch, sizeof(farMatch), &out[0], 6));
+	const char zeroOffset[] = { '\x10', 'a', '\x00', '\x00', '\x00' };
+	CHECK(!Util::lz4Decompress(zeroOffset, sizeof(zeroOffset), &out[0], 6));
+
+	// more literals than the block holds
+	const char longLiterals[] = { '\x50', 'a', 'b' };
+	CHECK(!Util::lz4Decompress(longLiterals, sizeof(longLiterals), &out[0], 5));
+
+	// a length continuation cut short
+	const char cutLength[] = { '\xF0', '\xFF' };
+	CHECK(!Util::lz4Decompress(cutLength, sizeof(cutLength), &out[0],
+			out.size()));
+
+	// flipped bytes are rejected or stay in bounds
+	for (size_t i = 0; i < compressed.size(); ++i)
+	{
+		std::string corrupted = compressed;
+		corrupted[i] = static_cast<char>(corrupted[i] ^ 0x5A);
+		std::string guarded(data.size() + 1, '\x5A');
+		Util::lz4Decompress(corrupted.data(), corrupted.size(), &guarded[0],
+				data.size());
+		CHECK(guarded[data.size()] == '\x5A');
+	}
+}
+
+/**
+ * Serialized TextResource entry of text, compressed in small blocks
+ */
+std::string serializeText(const std::string& text, size_t blockSize)
+{
+	Util::TextResource resource;
+	resource.setCompression(true, blockSize);
+	resource.loadFromMemory(text.data(), text.size());
+	std::string entry;
+	resource.serialize(entry);
+	return entry;
+}
+
+/**
+ * Load the entry in a new resource, compare with the text if it loads
+ */
+bool deserializeText(const std::string& entry, const std::string& text)
+{
+	Util::TextResource resource;
+	if (!resource.deserialize(entry.data(), entry.size()))
+	{
+		CHECK(!resource.isLoaded());
+		return false;
+	}
+	std::string copy;
+	resource.copyText(copy);
+	return copy == text;
+}
+
+/**
+ * Replace one of the size_t of the entry: the header, then 5 per block
+ */
+void setField(std::string& entry, size_t field, size_t value)
+{
+	std::memcpy(&entry[field * sizeof(size_t)], &value, sizeof(value));
+}
+
+size_t getField(const std::string& entry, size_t field)
+{
+	size_t value;
+	std::memcpy(&value, &entry[field * sizeof(size_t)], sizeof(value));
+	return value;
+}
+
+void testTextBlocks()
+{
+	// block boundaries: lines longer than a block, no final line break,
+	// nothing but line breaks, a single line
+	const std::string texts[] = { randomText(20000, 5), randomText(20000, 6)
+			+ "\n", std::string(3000, 'q') + "\nshort\n"
+			+ std::string(5000, 'r'), std::string(2000, '\n'), "one line",
+			"\n" };
+	const size_t blockSizes[] = { 1, 64, 1000, 16 * 1024 };
+	for (size_t t = 0; t < sizeof(texts) / sizeof(texts[0]); ++t)
+	{
+		for (size_t b = 0; b < sizeof(blockSizes) / sizeof(blockSizes[0]); ++b)
+		{
+			Util::TextResource resource;
+			resource.setCompression(true, blockSizes[b]);
+			CHECK(resource.loadFromMemory(texts[t].data(), texts[t].size()));
+			CHECK(resource.isCompressed());
+			std::string copy;
+			resource.copyText(copy);
+			CHECK(copy == texts[t]);
+
+			// every line, read through the block cache
+			Util::TextResource plain;
+			plain.setCompression(false);
+			plain.loadFromMemory(texts[t].data(), texts[t].size());
+			CHECK(resource.getLineCount() == plain.getLineCount());
+			for (size_t l = 0; l < plain.getLineCount(); ++l)
+			{
+				Util::TextView line = resource.getLine(l);
+				Util::TextView expected = plain.getLine(l);
+				CHECK(line.size() == expected.size()
+						&& std::memcmp(line.data(), expected.data(),
+								line.size()) == 0);
+			}
+
+			CHECK(deserializeText(serializeText(texts[t], blockSizes[b]),
+					texts[t]));
+		}
+	}
+
+	// an empty text has no block
+	CHECK(deserializeText(serializeText("", 64), ""));
+}
+
+void testCorruptEntries()
+{
+	std::string text = randomText(5000, 7);
+	std::string entry = serializeText(text, 512);
+	CHECK(deserializeText(entry, text));
+	size_t blockCount = getField(entry, 2);
+	CHECK(blockCount > 2);
+
+	// every truncation
+	for (size_t size = 0; size < entry.size(); ++size)
+	{
+		CHECK(!deserializeText(entry.substr(0, size), text));
+	}
+
+	// each figure of the header
+	std::string corrupted = entry;
+	setField(corrupted, 0, text.size() + 1);
+	CHECK(!deserializeText(corrupted, text));
+	corrupted = entry;
+	setField(corrupted, 1, getField(entry, 1) + 1);
+	CHECK(!deserializeText(corrupted, text));
+	corrupted = entry;
+	setField(corrupted, 2, static_cast<size_t>(-1) / 8);
+	CHECK(!deserializeText(corrupted, text));
+	corrupted = entry;
+	setField(corrupted, 2, blockCount - 1);
+	CHECK(!deserializeText(corrupted, text));
+
+	// each field of a block in the middle
+	for (size_t field = 0; field < 5; ++field)
+	{
+		size_t index = 3 + 5 + field;
+		size_t values[] = { getField(entry, index) + 1, getField(entry, index)
+				- 1, static_cast<size_t>(-1), 0 };
+		for (size_t v = 0; v < 4; ++v)
+		{
+			corrupted = entry;
+			setField(corrupted, index, values[v]);
+			CHECK(!deserializeText(corrupted, text));
+		}
+	}
+
+	// flipped bytes of the compressed data are rejected or stay in bounds
+	size_t dataStart = (3 + 5 * blockCount) * sizeof(size_t);
+	for (size_t i = dataStart; i < entry.size(); ++i)
+	{
+		corrupted = entry;
+		corrupted[i] = static_cast<char>(corrupted[i] ^ 0x21);
+		Util::TextResource resource;
+		if (resource.deserialize(corrupted.data(), corrupted.size()))
+		{
+			CHECK(resource.getSize() == text.size());
+			CHECK(resource.getLineCount() == getField(entry, 1));
+		}
+	}
+}
+
+void testCachedText()
+{
+	const std::string filename = "CompressionTest.txt";
+	std::string text = randomText(20000, 8);
+	CHECK(Util::writeFile(filename, text.data(), text.size()));
+	Util::ResourceCache cache("CompressionTest.cache");
+
+	// an uncompressed text can't be serialized, the cache stays out of it
+	Util::TextResource plain;
+	plain.setCompression(false);
+	CHECK(cache.load(plain, filename));
+	CHECK(cache.getMissCount() == 0 && cache.getHitCount() == 0);
+
+	// the blocks are written, then read back
+	for (int i = 0; i < 2; ++i)
+	{
+		Util::TextResource resource;
+		resource.setCompression(true, 1024);
+		CHECK(cache.load(resource, filename));
+		std::string copy;
+		resource.copyText(copy);
+		CHECK(copy == text);
+	}
+	CHECK(cache.getMissCount() == 1 && cache.getHitCount() == 1);
+
+	Util::TextResource probe;
+	std::remove(cache.getEntryFilename(probe, filename).c_str());
+	std::remove(cache.getDirectory().c_str());
+	std::remove(filename.c_str());
+}
+
+}
+
+void Test::testCompression()
+{
+	testRoundTrips();
+	testCorruptBlocks();
+	testTextBlocks();
+	testCorruptEntries();
+	testCachedText();
+}
@@ -0,0 +1,150 @@
+/*
+ * @file	LuaResourceTest.cpp
+ * @date	2026-10-19
+ * @brief	LuaResource loaded through a ResourceCache, and the execution
+ * 			limits.
+ */
+
+#include "Test.h"
+#include "Util/Resource/LuaResource.h"
+#include "Util/Resource/ResourceCache.h"
+#include "Util/FileHelper.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace
+{
+
+const char * const SCRIPT_FILENAME = "LuaResourceTest.lua";
+const char * const RUNS_FILENAME = "LuaResourceTest.runs";
+const char * const FAIL_FILENAME = "LuaResourceTest.fail";
+const char * const CACHE_DIRECTORY = "LuaResourceTest.cache";
+
+bool writeText(const std::string& filename, const std::string& text)
+{
+	return Util::writeFile(filename, text.data(), text.size());
+}
+
+/**
+ * Number of times the script of cachedScript() ran
+ */
+size_t countRuns()
+{
+	std::string runs;
+	Util::readFile(RUNS_FILENAME, runs);
+	return runs.size();
+}
+
+/**
+ * The same source succeeds or fails, so a cache entry written by a
+ * success is used by the failing run. Each run adds a byte to a file.
+ */
+std::string cachedScript()
+{
+	return std::string("local runs = io.open(\"") + RUNS_FILENAME + "\", \"a\")\n"
+			"runs:write(\"x\")\n"
+			"runs:close()\n"
+			"local fail = io.open(\"" + FAIL_FILENAME + "\", \"r\")\n"
+			"if fail then\n"
+			"	fail:close()\n"
+			"	error(\"asked to fail\")\n"
+			"end\n"
+			"value = 42\n";
+}
+
+void testFailingCachedScript()
+{
+	std::remove(RUNS_FILENAME);
+	std::remove(FAIL_FILENAME);
+	CHECK(writeText(SCRIPT_FILENAME, cachedScript()));
+	Util::ResourceCache cache(CACHE_DIRECTORY);
+
+	// the first load writes the entry
+	{
+		Util::LuaResource resource;
+		CHECK(cache.load(resource, SCRIPT_FILENAME));
+		CHECK(resource.getIntValue("value") == 42);
+		CHECK(cache.getMissCount() == 1 && cache.getHitCount() == 0);
+	}
+	CHECK(countRuns() == 1);
+
+	// the entry is used, and a script failing from it runs only once
+	CHECK(writeText(FAIL_FILENAME, "1"));
+	{
+		Util::LuaResource resource;
+		CHECK(!cache.load(resource, SCRIPT_FILENAME));
+		CHECK(!resource.isLoaded());
+		CHECK(resource.getLastError().find("asked to fail")
+				!= std::string::npos);
+		CHECK(cache.getMissCount() == 1 && cache.getHitCount() == 1);
+	}
+	CHECK(countRuns() == 2);
+
+	// an unusable entry still falls back on the source
+	Util::LuaResource probe;
+	std::string entryFilename = cache.getEntryFilename(probe, SCRIPT_FILENAME);
+	CHECK(writeText(entryFilename, "not an entry"));
+	std::remove(FAIL_FILENAME);
+	{
+		Util::LuaResource resource;
+		CHECK(cache.load(resource, SCRIPT_FILENAME));
+		CHECK(resource.getIntValue("value") == 42);
+		CHECK(cache.getMissCount() == 2);
+	}
+	CHECK(countRuns() == 3);
+
+	std::remove(entryFilename.c_str());
+	std::remove(CACHE_DIRECTORY);
+	std::remove(SCRIPT_FILENAME);
+	std::remove(RUNS_FILENAME);
+}
+
+bool loadScript(Util::LuaResource& resource, const char * script)
+{
+	return resource.loadFromMemory(script, std::strlen(script));
+}
+
+bool errorContains(const Util::LuaResource& resource, const char * text)
+{
+	return resource.getLastError().find(text) != std::string::npos;
+}
+
+void testExecutionLimits()
+{
+	// the instruction limit stops an infinite loop
+	Util::LuaResource resource;
+	resource.setExecutionLimits(100000, 0);
+	CHECK(!loadScript(resource, "while true do end"));
+	CHECK(!resource.isLoaded());
+	CHECK(errorContains(resource, "instruction limit"));
+
+	// so does the time limit, well before a second
+	resource.setExecutionLimits(0, 20000);
+	std::chrono::steady_clock::time_point start =
+			std::chrono::steady_clock::now();
+	CHECK(!loadScript(resource, "local i = 0 while true do i = i + 1 end"));
+	CHECK(errorContains(resource, "time limit"));
+	CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+
+	// a script catching the error is stopped again
+	resource.setExecutionLimits(100000, 0);
+	CHECK(!loadScript(resource,
+			"while true do pcall(function() while true do end end) end"));
+	CHECK(errorContains(resource, "instruction limit"));
+
+	// each load starts with a new count
+	CHECK(loadScript(resource, "value = 0 for i = 1, 1000 do value = i end"));
+	CHECK(resource.getIntValue("value") == 1000);
+	CHECK(loadScript(resource, "value = 0 for i = 1, 1000 do value = i end"));
+}
+
+}
+
+void Test::testLuaResource()
+{
+	testFailingCachedScript();
+	testExecutionLimits();
+}
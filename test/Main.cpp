@@ -2,9 +2,23 @@
  * @file	Main.cpp
  * @date	2015-01-10
  * @author	Emile
- * @brief	
+ * @brief	Runs every test, the exit code is the number of failed checks.
  */
 
+#include "Test.h"
 
+int main()
+{
+	Test::testCompression();
+	Test::testTextPieceTable();
+	Test::testRotation2();
+	Test::testVector2Array();
+	Test::testResourceManager();
+	Test::testLuaResource();
 
-
+	if (Test::failureCount() == 0)
+	{
+		std::printf("All tests passed\n");
+	}
+	return Test::failureCount();
+}
@@ -0,0 +1,143 @@
+/*
+ * @file	TResourceManagerTest.cpp
+ * @date	2026-10-19
+ * @brief	The parallel reload of the TResourceManager.
+ */
+
+#include "Test.h"
+#include "Util/Resource/TResourceManager.h"
+#include "Util/Resource/TextResource.h"
+#include "Util/ThreadPool.h"
+#include "Util/FileHelper.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/**
+ * Can't swap its content, counts its loads
+ */
+class CountedResource: public Util::Resource
+{
+	public:
+		CountedResource() :
+				mLoadCount(0)
+		{
+		}
+
+		bool load(const std::string& /*filename*/)
+		{
+			++mLoadCount;
+			setLoaded(true);
+			return true;
+		}
+
+		int mLoadCount;
+};
+
+std::string textOf(const Util::TextResource& resource)
+{
+	std::string text;
+	resource.copyText(text);
+	return text;
+}
+
+const Util::ResourceReloadResult * findResult(
+		const std::vector<Util::ResourceReloadResult>& results,
+		const std::string& filename)
+{
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		if (results[i].filename == filename)
+		{
+			return &results[i];
+		}
+	}
+	return NULL;
+}
+
+void testMissingFile()
+{
+	const std::string kept = "TResourceManagerTest.kept.txt";
+	const std::string missing = "TResourceManagerTest.missing.txt";
+	CHECK(Util::writeFile(kept, "old kept", 8));
+	CHECK(Util::writeFile(missing, "old missing", 11));
+
+	typedef Util::TResourceManager<Util::TextResource> Manager;
+	Manager * manager = Manager::getInstance();
+	Util::TextResource * keptResource = manager->load(kept);
+	Util::TextResource * missingResource = manager->load(missing);
+	CHECK(keptResource != NULL && missingResource != NULL);
+	if (keptResource == NULL || missingResource == NULL)
+	{
+		return;
+	}
+
+	// one file changed, the other one is gone
+	CHECK(Util::writeFile(kept, "new kept", 8));
+	std::remove(missing.c_str());
+	Util::ThreadPool pool(4);
+	std::vector<Util::ResourceReloadResult> results = manager->reloadAll(pool);
+	CHECK(results.size() == 2);
+
+	const Util::ResourceReloadResult * keptResult = findResult(results, kept);
+	const Util::ResourceReloadResult * missingResult = findResult(results,
+			missing);
+	CHECK(keptResult != NULL && keptResult->success && !keptResult->skipped);
+	CHECK(missingResult != NULL && !missingResult->success
+			&& !missingResult->skipped);
+
+	// the same objects, the failed one with its previous content
+	CHECK(manager->load(kept) == keptResource);
+	CHECK(manager->load(missing) == missingResource);
+	CHECK(textOf(*keptResource) == "new kept");
+	CHECK(missingResource->isLoaded());
+	CHECK(textOf(*missingResource) == "old missing");
+
+	Util::ResourceManagerStats stats = manager->getStats();
+	for (size_t i = 0; i < stats.resources.size(); ++i)
+	{
+		const Util::ResourceStats& resourceStats = stats.resources[i];
+		bool failed = (resourceStats.filename == missing);
+		CHECK(resourceStats.reloadCount == (failed ? 0u : 1u));
+		CHECK(resourceStats.reloadFailureCount == (failed ? 1u : 0u));
+	}
+
+	manager->deleteAll();
+	std::remove(kept.c_str());
+}
+
+void testSkippedType()
+{
+	typedef Util::TResourceManager<CountedResource> Manager;
+	Manager * manager = Manager::getInstance();
+	CountedResource * resource = manager->load("counted");
+	CHECK(resource != NULL && resource->mLoadCount == 1);
+
+	// it would be reloaded in place, where it can be seen half done
+	Util::ThreadPool pool(2);
+	std::vector<Util::ResourceReloadResult> results = manager->reloadAll(pool);
+	CHECK(results.size() == 1);
+	CHECK(results.size() == 1 && results[0].skipped && !results[0].success);
+	CHECK(resource->mLoadCount == 1);
+	Util::ResourceManagerStats stats = manager->getStats();
+	CHECK(stats.resources.size() == 1
+			&& stats.resources[0].reloadFailureCount == 0);
+
+	// the serial reload still does it
+	results = manager->reloadAll();
+	CHECK(results.size() == 1 && results[0].success && !results[0].skipped);
+	CHECK(resource->mLoadCount == 2);
+	manager->deleteAll();
+}
+
+}
+
+void Test::testResourceManager()
+{
+	testMissingFile();
+	testSkippedType();
+}
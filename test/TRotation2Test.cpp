@@ -0,0 +1,152 @@
+/*
+ * @file	TRotation2Test.cpp
+ * @date	2026-10-19
+ * @brief	The error bounds documented on fastSinCos(), and TRotation2.
+ */
+
+#include "Test.h"
+#include "Util/TRotation2.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+
+/**
+ * Largest absolute error of fastSinCos() against the double precision
+ * sin() and cos(), measured like the documentation: 4 million angles
+ * evenly spread on [-range, range].
+ */
+double measureError(double range)
+{
+	const int ANGLE_COUNT = 4000000;
+	double largest = 0.0;
+	for (int i = 0; i <= ANGLE_COUNT; ++i)
+	{
+		float radians = static_cast<float>(-range
+				+ 2.0 * range * i / ANGLE_COUNT);
+		float sinAngle;
+		float cosAngle;
+		Util::fastSinCos(radians, sinAngle, cosAngle);
+
+		// the exact angle is the float one
+		double angle = radians;
+		largest = std::max(largest, std::fabs(sinAngle - std::sin(angle)));
+		largest = std::max(largest, std::fabs(cosAngle - std::cos(angle)));
+	}
+	return largest;
+}
+
+void testFastSinCosBounds()
+{
+	// keep in sync with the documentation of fastSinCos()
+	CHECK(measureError(1000 * M_PI) <= 9.3e-8);
+	CHECK(measureError(10000 * M_PI) <= 4.9e-7);
+	CHECK(measureError(102943) <= 9.7e-7);
+	CHECK(measureError(1e6) <= 3.2e-2);
+	CHECK(measureError(1.3e7) <= 0.5);
+}
+
+void testFastSinCosLimits()
+{
+	// exact at the quadrant boundaries, with the right signs
+	const float angles[] = { 0.0f, static_cast<float>(M_PI_2),
+			static_cast<float>(M_PI), static_cast<float>(-M_PI_2) };
+	const float expectedSin[] = { 0.0f, 1.0f, 0.0f, -1.0f };
+	const float expectedCos[] = { 1.0f, 0.0f, -1.0f, 0.0f };
+	for (int i = 0; i < 4; ++i)
+	{
+		float sinAngle;
+		float cosAngle;
+		Util::fastSinCos(angles[i], sinAngle, cosAngle);
+		CHECK(std::fabs(sinAngle - expectedSin[i]) <= 1e-7f);
+		CHECK(std::fabs(cosAngle - expectedCos[i]) <= 1e-7f);
+	}
+
+	// past the limit only the quadrant conversion must stay defined,
+	// which -fsanitize=undefined checks
+	float sinAngle;
+	float cosAngle;
+	const float beyond[] = { 1.4e7f, -1e20f,
+			std::numeric_limits<float>::infinity(),
+			-std::numeric_limits<float>::infinity() };
+	for (int i = 0; i < 4; ++i)
+	{
+		Util::fastSinCos(beyond[i], sinAngle, cosAngle);
+	}
+	Util::fastSinCos(std::numeric_limits<float>::quiet_NaN(), sinAngle,
+			cosAngle);
+	CHECK(sinAngle != sinAngle && cosAngle != cosAngle);
+
+	// the array overload gives the same results
+	std::vector<float> radians;
+	for (int i = -1000; i <= 1000; ++i)
+	{
+		radians.push_back(i * 0.37f);
+	}
+	std::vector<float> sines(radians.size());
+	std::vector<float> cosines(radians.size());
+	Util::fastSinCos(&radians[0], &sines[0], &cosines[0], radians.size());
+	for (size_t i = 0; i < radians.size(); ++i)
+	{
+		Util::fastSinCos(radians[i], sinAngle, cosAngle);
+		CHECK(sines[i] == sinAngle && cosines[i] == cosAngle);
+	}
+}
+
+bool near(const Util::TVector2<float>& v, float x, float y)
+{
+	return std::fabs(v.getX() - x) <= 1e-5f && std::fabs(v.getY() - y) <= 1e-5f;
+}
+
+void testRotation()
+{
+	Util::TRotation2<float> quarter = Util::TRotation2<float>::fromDegrees(90);
+	CHECK(near(quarter.rotate(Util::TVector2<float>(1, 0)), 0, 1));
+	CHECK(near(quarter.inverse().rotate(Util::TVector2<float>(1, 0)), 0, -1));
+	CHECK(near((quarter * quarter).rotate(Util::TVector2<float>(1, 2)), -1, -2));
+	CHECK(std::fabs(quarter.getRadians() - static_cast<float>(M_PI_2)) <= 1e-6f);
+
+	// like TVector2::rotate()
+	Util::TVector2<float> v(3, -4);
+	Util::TRotation2<float> rotation = Util::TRotation2<float>::fromDegrees(33);
+	Util::TVector2<float> expected = v.rotate(33);
+	CHECK(near(rotation.rotate(v), expected.getX(), expected.getY()));
+	Util::TRotation2<float> fast = Util::TRotation2<float>::fromRadiansFast(
+			static_cast<float>(33 * M_PI / 180));
+	CHECK(near(fast.rotate(v), expected.getX(), expected.getY()));
+
+	Util::TRotation2<float> direction = Util::TRotation2<float>::fromDirection(
+			Util::TVector2<float>(0, 5));
+	CHECK(near(direction.rotate(Util::TVector2<float>(2, 0)), 0, 2));
+
+	// the three ways to rotate many vectors agree
+	Util::TVector2Array<float> array;
+	std::vector<Util::TVector2<float> > vectors;
+	for (int i = 0; i < 37; ++i)
+	{
+		vectors.push_back(Util::TVector2<float>(i * 0.5f, 10.0f - i));
+		array.append(vectors.back());
+	}
+	std::vector<Util::TVector2<float> > rotated(vectors.size());
+	rotation.rotate(&vectors[0], &rotated[0], vectors.size());
+	rotation.rotate(array);
+	for (size_t i = 0; i < vectors.size(); ++i)
+	{
+		Util::TVector2<float> one = rotation.rotate(vectors[i]);
+		CHECK(near(rotated[i], one.getX(), one.getY()));
+		CHECK(near(array.get(i), one.getX(), one.getY()));
+	}
+}
+
+}
+
+void Test::testRotation2()
+{
+	testFastSinCosBounds();
+	testFastSinCosLimits();
+	testRotation();
+}
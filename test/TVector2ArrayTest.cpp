@@ -0,0 +1,210 @@
+/*
+ * @file	TVector2ArrayTest.cpp
+ * @date	2026-10-19
+ * @brief	The vectorized float kernels against the generic ones.
+ */
+
+#include "Test.h"
+#include "Util/TVector2Array.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+/**
+ * Around the pack sizes of SSE and AVX, with and without a scalar tail
+ */
+const size_t SIZES[] = { 0, 1, 7, 9, 33 };
+const size_t SIZE_COUNT = sizeof(SIZES) / sizeof(SIZES[0]);
+
+/**
+ * Written past the count, a kernel must leave it
+ */
+const float GUARD = 12345.0f;
+
+/**
+ * count values and the guard, every third vector of the x and y made by
+ * randomArrays() is null
+ */
+std::vector<float> randomArray(Test::Random& random, size_t count)
+{
+	std::vector<float> values(count + 1, GUARD);
+	for (size_t i = 0; i < count; ++i)
+	{
+		values[i] = (static_cast<float>(random.next(20001)) - 10000.0f)
+				/ 100.0f;
+	}
+	return values;
+}
+
+void randomArrays(Test::Random& random, size_t count, std::vector<float>& x,
+		std::vector<float>& y)
+{
+	x = randomArray(random, count);
+	y = randomArray(random, count);
+	for (size_t i = 0; i < count; i += 3)
+	{
+		x[i] = 0.0f;
+		y[i] = 0.0f;
+	}
+}
+
+/**
+ * The generic kernels may use other instructions, e.g. a fused
+ * multiply-add, and distance() goes through pow()
+ */
+bool near(float a, float b)
+{
+	return std::fabs(a - b) <= 1e-5f * (1.0f + std::fabs(b));
+}
+
+bool near(const std::vector<float>& a, const std::vector<float>& b)
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (!near(a[i], b[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void testArithmetic()
+{
+	Test::Random random(1);
+	for (size_t s = 0; s < SIZE_COUNT; ++s)
+	{
+		size_t count = SIZES[s];
+		std::vector<float> x;
+		std::vector<float> y;
+		randomArrays(random, count, x, y);
+		std::vector<float> otherX = randomArray(random, count);
+		std::vector<float> otherY = randomArray(random, count);
+
+		std::vector<float> fastX = x;
+		std::vector<float> fastY = y;
+		std::vector<float> slowX = x;
+		std::vector<float> slowY = y;
+		Util::addVectors(&fastX[0], &fastY[0], &otherX[0], &otherY[0], count);
+		Util::addVectors<float>(&slowX[0], &slowY[0], &otherX[0], &otherY[0],
+				count);
+		CHECK(fastX == slowX && fastY == slowY);
+
+		Util::translateVectors(&fastX[0], &fastY[0], 1.5f, -2.25f, count);
+		Util::translateVectors<float>(&slowX[0], &slowY[0], 1.5f, -2.25f,
+				count);
+		CHECK(fastX == slowX && fastY == slowY);
+
+		Util::scaleVectors(&fastX[0], &fastY[0], -0.75f, count);
+		Util::scaleVectors<float>(&slowX[0], &slowY[0], -0.75f, count);
+		CHECK(fastX == slowX && fastY == slowY);
+
+		float cosAngle = std::cos(0.3f);
+		float sinAngle = std::sin(0.3f);
+		Util::rotateVectors(&fastX[0], &fastY[0], cosAngle, sinAngle, count);
+		Util::rotateVectors<float>(&slowX[0], &slowY[0], cosAngle, sinAngle,
+				count);
+		CHECK(near(fastX, slowX) && near(fastY, slowY));
+		CHECK(fastX[count] == GUARD && fastY[count] == GUARD);
+
+		std::vector<float> fastOut(count + 1, GUARD);
+		std::vector<float> slowOut(count + 1, GUARD);
+		Util::dotVectors(&x[0], &y[0], &otherX[0], &otherY[0], &fastOut[0],
+				count);
+		Util::dotVectors<float>(&x[0], &y[0], &otherX[0], &otherY[0],
+				&slowOut[0], count);
+		CHECK(near(fastOut, slowOut));
+
+		Util::distanceVectors(&x[0], &y[0], &otherX[0], &otherY[0],
+				&fastOut[0], count);
+		Util::distanceVectors<float>(&x[0], &y[0], &otherX[0], &otherY[0],
+				&slowOut[0], count);
+		CHECK(near(fastOut, slowOut));
+		CHECK(fastOut[count] == GUARD);
+	}
+}
+
+void testNormalize()
+{
+	Test::Random random(2);
+	for (size_t s = 0; s < SIZE_COUNT; ++s)
+	{
+		size_t count = SIZES[s];
+		std::vector<float> x;
+		std::vector<float> y;
+		randomArrays(random, count, x, y);
+
+		// the blend keeps the null vectors, in the packs and the tail
+		std::vector<float> fastX = x;
+		std::vector<float> fastY = y;
+		std::vector<float> slowX = x;
+		std::vector<float> slowY = y;
+		Util::normalizeVectors(&fastX[0], &fastY[0], count);
+		Util::normalizeVectors<float>(&slowX[0], &slowY[0], count);
+		CHECK(near(fastX, slowX) && near(fastY, slowY));
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (i % 3 == 0)
+			{
+				CHECK(fastX[i] == 0.0f && fastY[i] == 0.0f);
+			}
+			else
+			{
+				float length = std::sqrt(fastX[i] * fastX[i]
+						+ fastY[i] * fastY[i]);
+				CHECK(near(length, 1.0f));
+			}
+		}
+		CHECK(fastX[count] == GUARD && fastY[count] == GUARD);
+	}
+}
+
+void testSplitJoin()
+{
+	Test::Random random(3);
+	for (size_t s = 0; s < SIZE_COUNT; ++s)
+	{
+		size_t count = SIZES[s];
+		std::vector<float> x = randomArray(random, count);
+		std::vector<float> y = randomArray(random, count);
+		Util::TVector2<float> guard(GUARD, GUARD);
+
+		std::vector<Util::TVector2<float> > fastVectors(count + 1, guard);
+		std::vector<Util::TVector2<float> > slowVectors(count + 1, guard);
+		Util::joinVectors(&x[0], &y[0], &fastVectors[0], count);
+		Util::joinVectors<float>(&x[0], &y[0], &slowVectors[0], count);
+		for (size_t i = 0; i <= count; ++i)
+		{
+			CHECK(fastVectors[i].getX() == slowVectors[i].getX()
+					&& fastVectors[i].getY() == slowVectors[i].getY());
+		}
+		CHECK(fastVectors[count].getX() == GUARD);
+
+		// and back, the shuffles must give the arrays they were made of
+		std::vector<float> fastX(count + 1, GUARD);
+		std::vector<float> fastY(count + 1, GUARD);
+		std::vector<float> slowX(count + 1, GUARD);
+		std::vector<float> slowY(count + 1, GUARD);
+		Util::splitVectors(&fastVectors[0], &fastX[0], &fastY[0], count);
+		Util::splitVectors<float>(&slowVectors[0], &slowX[0], &slowY[0],
+				count);
+		CHECK(fastX == slowX && fastY == slowY);
+		CHECK(fastX == x && fastY == y);
+	}
+}
+
+}
+
+void Test::testVector2Array()
+{
+	testArithmetic();
+	testNormalize();
+	testSplitJoin();
+}
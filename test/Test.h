@@ -0,0 +1,76 @@
+/*
+ * @file	Test.h
+ * @date	2026-10-19
+ * @brief	Minimal checks shared by the tests, run from Main.cpp.
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <cstdio>
+
+namespace Test
+{
+
+/**
+ * Number of failed checks of the whole run
+ */
+inline int& failureCount()
+{
+	static int count = 0;
+	return count;
+}
+
+inline bool check(bool condition, const char * expression, const char * file,
+		int line)
+{
+	if (!condition)
+	{
+		std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line,
+				expression);
+		++failureCount();
+	}
+	return condition;
+}
+
+/**
+ * Small deterministic generator, the runs are reproducible
+ */
+class Random
+{
+	public:
+		explicit Random(unsigned int seed) :
+						mState(seed)
+		{
+		}
+
+		unsigned int next()
+		{
+			mState = mState * 1664525U + 1013904223U;
+			return mState >> 8;
+		}
+
+		/**
+		 * @return in [0, bound)
+		 */
+		unsigned int next(unsigned int bound)
+		{
+			return next() % bound;
+		}
+
+	private:
+		unsigned int mState;
+};
+
+void testCompression();
+void testTextPieceTable();
+void testRotation2();
+void testVector2Array();
+void testResourceManager();
+void testLuaResource();
+
+}
+
+#define CHECK(condition) Test::check((condition), #condition, __FILE__, __LINE__)
+
+#endif /* TEST_H_ */
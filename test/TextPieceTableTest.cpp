@@ -0,0 +1,419 @@
+/*
+ * @file	TextPieceTableTest.cpp
+ * @date	2026-10-19
+ * @brief	TextPieceTable against a std::string model, and the edits of
+ * 			a TextResource.
+ */
+
+#include "Test.h"
+#include "Util/TextPieceTable.h"
+#include "Util/Resource/TextResource.h"
+#include "Util/FileHelper.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/**
+ * Mostly letters, with line breaks, a few "\r\n" and spaces
+ */
+std::string randomText(Test::Random& random, size_t size)
+{
+	std::string text;
+	while (text.size() < size)
+	{
+		unsigned int kind = random.next(16);
+		if (kind == 0)
+		{
+			text += '\n';
+		}
+		else if (kind == 1)
+		{
+			text += "\r\n";
+		}
+		else if (kind == 2)
+		{
+			text += ' ';
+		}
+		else
+		{
+			text += static_cast<char>('a' + random.next(26));
+		}
+	}
+	text.resize(size);
+	return text;
+}
+
+/**
+ * Offset of the first character of each line
+ */
+std::vector<size_t> modelLineStarts(const std::string& text)
+{
+	std::vector<size_t> starts;
+	size_t offset = 0;
+	while (offset < text.size())
+	{
+		starts.push_back(offset);
+		size_t lineBreak = text.find('\n', offset);
+		if (lineBreak == std::string::npos)
+		{
+			break;
+		}
+		offset = lineBreak + 1;
+	}
+	return starts;
+}
+
+size_t modelLineCount(const std::string& text)
+{
+	return modelLineStarts(text).size();
+}
+
+std::string modelLine(const std::string& text,
+		const std::vector<size_t>& starts, size_t line)
+{
+	if (line >= starts.size())
+	{
+		return std::string();
+	}
+	size_t begin = starts[line];
+	size_t end = (line + 1 < starts.size()) ? starts[line + 1] - 1 : text.size();
+	if (end > begin && text[end - 1] == '\n')
+	{
+		--end;
+	}
+	if (end > begin && text[end - 1] == '\r')
+	{
+		--end;
+	}
+	return text.substr(begin, end - begin);
+}
+
+/**
+ * Size and content, and the pieces put end to end
+ */
+bool sameText(const Util::TextPieceTable& table, const std::string& model)
+{
+	std::string copy;
+	table.copyText(copy);
+	std::string pieces;
+	table.forEachPiece(0, table.getSize(), [&pieces](Util::TextView piece)
+	{
+		pieces.append(piece.data(), piece.size());
+	});
+	return table.getSize() == model.size() && table.empty() == model.empty()
+			&& copy == model && pieces == model;
+}
+
+/**
+ * Every line accessor, and a few ranges and characters
+ */
+void checkLines(const Util::TextPieceTable& table, const std::string& model,
+		Test::Random& random)
+{
+	std::vector<size_t> starts = modelLineStarts(model);
+	size_t lineCount = starts.size();
+	CHECK(table.getLineCount() == lineCount);
+	for (size_t line = 0; line <= lineCount; ++line)
+	{
+		size_t offset = (line < lineCount) ? starts[line] : model.size();
+		CHECK(table.getLineOffset(line) == offset);
+		std::string copy;
+		table.copyLine(line, copy);
+		CHECK(copy == modelLine(model, starts, line));
+	}
+
+	for (int i = 0; i < 20 && !model.empty(); ++i)
+	{
+		size_t offset = random.next(static_cast<unsigned int>(model.size()));
+		CHECK(table.at(offset) == model[offset]);
+
+		size_t line = static_cast<size_t>(std::count(model.begin(),
+				model.begin() + offset, '\n'));
+		CHECK(table.getLineOfOffset(offset) == std::min(line, lineCount - 1));
+
+		size_t length = random.next(200);
+		std::string range;
+		table.copyText(offset, length, range);
+		CHECK(range == model.substr(offset, length));
+	}
+}
+
+/**
+ * One random edit on both, the history of the model follows the rules
+ * of the table: only the edits that change something are recorded,
+ * except replace() which always is.
+ */
+void randomEdit(Util::TextPieceTable& table, std::string& model,
+		std::vector<std::string>& history, Test::Random& random)
+{
+	// a bit past the end, to check the clamping
+	size_t offset = random.next(static_cast<unsigned int>(model.size() + 10));
+	size_t length = random.next(50) == 0 ? model.size() : random.next(100);
+	std::string text = randomText(random, random.next(40));
+	size_t clamped = std::min(offset, model.size());
+
+	switch (random.next(3))
+	{
+		case 0:
+			if (!text.empty())
+			{
+				history.push_back(model);
+			}
+			table.insert(offset, Util::TextView(text));
+			model.insert(clamped, text);
+			break;
+		case 1:
+			if (offset < model.size() && length > 0)
+			{
+				history.push_back(model);
+			}
+			table.erase(offset, length);
+			model.erase(clamped, length);
+			break;
+		default:
+			history.push_back(model);
+			table.replace(offset, length, Util::TextView(text));
+			model.replace(clamped, length, text);
+			break;
+	}
+}
+
+void testRandomEdits()
+{
+	for (unsigned int seed = 1; seed <= 8; ++seed)
+	{
+		Test::Random random(seed);
+
+		// longer than MAX_PIECE_SIZE, so it starts as several pieces
+		std::string original = randomText(random,
+				seed * 3 * Util::TextPieceTable::MAX_PIECE_SIZE / 2);
+		Util::TextPieceTable table((Util::TextView(original)));
+		std::string model = original;
+		CHECK(sameText(table, model));
+		checkLines(table, model, random);
+
+		std::vector<std::string> history;
+		for (int step = 0; step < 400; ++step)
+		{
+			randomEdit(table, model, history, random);
+			CHECK(sameText(table, model));
+			if (step % 40 == 0)
+			{
+				checkLines(table, model, random);
+			}
+		}
+		checkLines(table, model, random);
+
+		// the original text is never written
+		Test::Random again(seed);
+		CHECK(original == randomText(again, original.size()));
+
+		// all the way back, then forward again
+		std::vector<std::string> redone;
+		while (!history.empty())
+		{
+			CHECK(table.canUndo());
+			redone.push_back(model);
+			model = history.back();
+			history.pop_back();
+			CHECK(table.undo());
+			CHECK(sameText(table, model));
+		}
+		CHECK(!table.canUndo() && !table.undo());
+		CHECK(model == original);
+		while (!redone.empty())
+		{
+			CHECK(table.redo());
+			model = redone.back();
+			redone.pop_back();
+			CHECK(sameText(table, model));
+		}
+		CHECK(!table.canRedo() && !table.redo());
+		checkLines(table, model, random);
+	}
+}
+
+void testTyping()
+{
+	// characters added one by one at the same place grow a single piece
+	std::string original = "first line\nsecond line\n";
+	Util::TextPieceTable table((Util::TextView(original)));
+	std::string model = original;
+	size_t offset = 11;
+	const std::string typed = "typed in the middle\n";
+	for (size_t i = 0; i < typed.size(); ++i)
+	{
+		table.insert(offset + i, Util::TextView(typed.data() + i, 1));
+		model.insert(offset + i, 1, typed[i]);
+	}
+	CHECK(sameText(table, model));
+	CHECK(table.getPieceCount() <= 3);
+	CHECK(table.getLineCount() == 3);
+
+	// backspaces at the end of the inserted text
+	for (size_t i = 0; i < typed.size(); ++i)
+	{
+		table.erase(offset + typed.size() - 1 - i, 1);
+	}
+	CHECK(sameText(table, original));
+
+	// no-ops don't enter the history
+	table.clearHistory();
+	table.insert(3, Util::TextView(""));
+	table.erase(model.size() + 5, 3);
+	table.erase(2, 0);
+	CHECK(!table.canUndo());
+
+	Util::TextPieceTable empty;
+	CHECK(empty.empty() && empty.getLineCount() == 0);
+	CHECK(empty.getLineOfOffset(0) == 0 && empty.getPieceCount() == 0);
+	empty.insert(0, Util::TextView("\n"));
+	CHECK(empty.getLineCount() == 1 && empty.getLineOffset(1) == 1);
+}
+
+void testSnapshots()
+{
+	Test::Random random(42);
+	std::string original = randomText(random, 10000);
+	Util::TextPieceTable table((Util::TextView(original)));
+	std::string model = original;
+
+	std::vector<Util::TextPieceTable::Snapshot> snapshots;
+	std::vector<std::string> expected;
+	std::vector<std::string> history;
+	for (int step = 0; step < 300; ++step)
+	{
+		if (step % 25 == 0)
+		{
+			snapshots.push_back(table.getSnapshot());
+			expected.push_back(model);
+		}
+		randomEdit(table, model, history, random);
+	}
+
+	// the later edits never changed what a snapshot sees
+	std::string last = model;
+	for (size_t i = 0; i < snapshots.size(); ++i)
+	{
+		CHECK(snapshots[i].getSize() == expected[i].size());
+		table.restore(snapshots[i]);
+		CHECK(sameText(table, expected[i]));
+
+		// a restore is a single step back
+		CHECK(table.undo());
+		CHECK(sameText(table, last));
+		CHECK(table.redo());
+
+		// editing a restored version leaves the snapshot as it was
+		table.insert(0, Util::TextView("edited after the restore\n"));
+		table.erase(table.getSize() / 2, 100);
+		last.clear();
+		table.copyText(last);
+		table.restore(snapshots[i]);
+		CHECK(sameText(table, expected[i]));
+		table.undo();
+	}
+
+	Util::TextPieceTable::Snapshot none;
+	CHECK(none.getSize() == 0);
+	table.restore(none);
+	CHECK(table.empty());
+}
+
+/**
+ * Text of a resource, in both modes
+ */
+std::string textOf(const Util::TextResource& resource)
+{
+	std::string text;
+	resource.copyText(text);
+	return text;
+}
+
+void testResourceEdits()
+{
+	Test::Random random(7);
+	std::string original = randomText(random, 50000);
+
+	// mapped from a file, in memory, and compressed
+	const std::string filename = "TextPieceTableTest.txt";
+	CHECK(Util::writeFile(filename, original.data(), original.size()));
+	for (int mode = 0; mode < 3; ++mode)
+	{
+		Util::TextResource resource;
+		resource.setCompression(mode == 2, 4096);
+		bool loaded = (mode == 0) ? resource.load(filename)
+				: resource.loadFromMemory(original.data(), original.size());
+		CHECK(loaded);
+		CHECK(!resource.isEditing());
+
+		// the resource keeps the loaded text until applyEdit()
+		Util::TextPieceTable& table = resource.edit();
+		CHECK(resource.isEditing());
+		CHECK(&resource.edit() == &table);
+		std::string model = original;
+		std::vector<std::string> history;
+		for (int step = 0; step < 100; ++step)
+		{
+			randomEdit(table, model, history, random);
+		}
+		CHECK(sameText(table, model));
+		CHECK(textOf(resource) == original);
+
+		resource.cancelEdit();
+		CHECK(!resource.isEditing());
+		CHECK(textOf(resource) == original);
+		CHECK(resource.getLineCount() == modelLineCount(original));
+
+		// a new edit starts from the loaded text, then replaces it
+		Util::TextPieceTable& again = resource.edit();
+		CHECK(sameText(again, original));
+		again.insert(0, Util::TextView("inserted\r\n"));
+		again.erase(original.size() / 2, 1000);
+		again.insert(again.getSize(), Util::TextView("appended"));
+		std::string edited;
+		again.copyText(edited);
+		resource.applyEdit();
+		CHECK(!resource.isEditing());
+		CHECK(textOf(resource) == edited);
+		CHECK(resource.isCompressed() == (mode == 2));
+		CHECK(resource.getLineCount() == modelLineCount(edited));
+		std::vector<size_t> starts = modelLineStarts(edited);
+		for (size_t line = 0; line < resource.getLineCount(); line += 97)
+		{
+			Util::TextView view = resource.getLine(line);
+			CHECK(std::string(view.data(), view.size())
+					== modelLine(edited, starts, line));
+		}
+
+		// nothing to apply
+		resource.applyEdit();
+		CHECK(textOf(resource) == edited);
+
+		// a failed load keeps the text, a load from it reads it first
+		CHECK(!resource.load("TextPieceTableTest.missing"));
+		CHECK(resource.isLoaded() && textOf(resource) == edited);
+		if (mode == 1)
+		{
+			CHECK(resource.loadFromMemory(resource.getText().data(),
+					resource.getSize() / 2));
+			CHECK(textOf(resource) == edited.substr(0, edited.size() / 2));
+		}
+	}
+	std::remove(filename.c_str());
+}
+
+}
+
+void Test::testTextPieceTable()
+{
+	testRandomEdits();
+	testTyping();
+	testSnapshots();
+	testResourceEdits();
+}